@@ -0,0 +1,83 @@
+/**
+ * DIFI ingest (reverse direction of difi_dpdk_receiver): receive DIFI data
+ * packets over UDP and enqueue them as IQ chunks into the same per-stream
+ * rings / mempool that producers use, so local consumers (e.g. module_b)
+ * can drain them.
+ *
+ * Datagrams are received with recvmmsg() directly into mbufs. The 32-byte
+ * DIFI header sits where struct iq_chunk_hdr goes, so a packet that carries a
+ * whole chunk is converted in place (zero-copy). Packets carrying a fraction of
+ * a chunk are reassembled into one chunk mbuf, chained when the chunk is larger
+ * than one mbuf. With UDP GRO, coalesced datagrams are split into indirect
+ * mbufs (still zero-copy).
+ */
+#ifndef DIFI_INGEST_H
+#define DIFI_INGEST_H
+
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <rte_mbuf.h>
+#include <rte_mempool.h>
+#include <rte_ring.h>
+
+#include "common.h"
+
+#define DIFI_INGEST_BURST     32
+#define DIFI_INGEST_HDR_BYTES 32   /* same layout the receiver writes (see write_difi_header_variable) */
+
+struct difi_ingest_stream {
+	struct rte_mbuf *asm_m;      /* chunk being reassembled from segmented packets */
+	uint32_t asm_bytes;          /* payload bytes already in asm_m */
+	int      seen;               /* first data packet received */
+	uint8_t  last_seq;           /* last 4-bit DIFI sequence number */
+	uint64_t ext_seq;            /* DIFI sequence extended to 64 bits (modulo-16 steps) */
+	uint64_t packets;            /* data packets accepted */
+	uint64_t chunks;             /* chunks enqueued to the stream ring */
+	uint64_t seq_lost;           /* packets missing per 4-bit sequence gaps */
+	uint64_t duplicates;         /* packets repeating the previous sequence number (dropped) */
+	uint64_t reasm_drops;        /* partial chunks discarded after a gap */
+	uint64_t ctx_packets;        /* context packets seen for this stream */
+};
+
+struct difi_ingest {
+	int sock;
+	int gro;
+	struct rte_mempool *pool;
+	struct rte_ring **rings;     /* g_streams per-stream rings (single producer: this process) */
+	uint16_t streams;
+	uint32_t payload_bytes;      /* chunk payload the consumers expect */
+
+	struct difi_ingest_stream st[IQ_MAX_STREAMS];
+
+	uint64_t rx_calls;           /* recvmmsg calls that returned >= 1 datagram */
+	uint64_t rx_datagrams;
+	uint64_t rx_bytes;
+	uint64_t hdr_errors;         /* wrong packet type / class / size field / stream id */
+	uint64_t len_errors;         /* payload size not a divisor of the chunk, truncated datagram */
+	uint64_t other_packets;      /* non-data, non-context packet types */
+	uint64_t ring_full;          /* chunk dropped: stream ring full */
+	uint64_t no_mbuf;            /* mempool empty (receive slot or reassembly buffer) */
+
+	struct rte_mbuf *slots[DIFI_INGEST_BURST];
+	struct mmsghdr   msgs[DIFI_INGEST_BURST];
+	struct iovec     iovs[DIFI_INGEST_BURST];
+	union {
+		char buf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} cmsg[DIFI_INGEST_BURST];
+};
+
+/* Bind a non-blocking UDP socket on addr:port (optionally UDP_GRO) and set up state.
+ * Returns 0 on success, -1 on error (message printed). */
+int difi_ingest_open(struct difi_ingest *ing, const char *addr, uint16_t port, int gro,
+	struct rte_mempool *pool, struct rte_ring **rings, uint16_t streams, uint32_t payload_bytes);
+
+/* One recvmmsg burst: parse, validate, reassemble and enqueue. Returns datagrams received. */
+unsigned int difi_ingest_poll(struct difi_ingest *ing);
+
+/* Free slot mbufs and partial chunks, close the socket. */
+void difi_ingest_close(struct difi_ingest *ing);
+
+#endif /* DIFI_INGEST_H */
@@ -0,0 +1,106 @@
+/**
+ * Per-stage cycle accounting for the difi_dpdk_receiver drain/send hot path.
+ *
+ * Compiled in with -DDIFI_PROFILE (CMake option DIFI_PROFILE, default ON) and
+ * switched on at runtime with --profile; without either, every hook is a
+ * constant-false branch. Each lcore owns one struct difi_prof and is its only
+ * writer; the main lcore reads it for the periodic line and final summary.
+ *
+ * With -DDIFI_USDT (CMake option DIFI_USDT) the batch hooks also fire USDT
+ * probes (provider difi_dpdk_receiver) for correlation with perf / bpftrace.
+ */
+#ifndef DIFI_PROF_H
+#define DIFI_PROF_H
+
+#include <stdint.h>
+
+#include <rte_branch_prediction.h>
+#include <rte_cycles.h>
+
+#ifdef DIFI_USDT
+#include <sys/sdt.h>
+#define DIFI_USDT_PROBE2(name, a, b) DTRACE_PROBE2(difi_dpdk_receiver, name, a, b)
+#else
+#define DIFI_USDT_PROBE2(name, a, b) do { } while (0)
+#endif
+
+enum difi_prof_stage {
+	DIFI_PROF_DEQUEUE,   /* successful ring dequeue (reorder window push/pop included) */
+	DIFI_PROF_VALIDATE,  /* chunk header checks */
+	DIFI_PROF_HEADER,    /* DIFI header write, timestamp conversion, context scheduling */
+	DIFI_PROF_DSP,       /* iq_dsp_process */
+	DIFI_PROF_COPY,      /* memcpy into send buffers */
+	DIFI_PROF_HANDOFF,   /* send_ring / pool_ring / mempool handoff, sendmmsg batch build */
+	DIFI_PROF_SYSCALL,   /* sendmmsg */
+	DIFI_PROF_IDLE,      /* polls that found the ring empty; not a per-chunk cost */
+	DIFI_PROF_NSTAGES
+};
+
+/* sendmmsg batch sizes: 1, 2, 3-4, 5-8, 9-16, 17-32, >32 */
+#define DIFI_PROF_HIST_BINS 7
+
+struct difi_prof {
+	uint64_t cycles[DIFI_PROF_NSTAGES];
+	uint64_t chunks;        /* chunks (drain) or packets (send worker) handled */
+	uint64_t polls_empty;   /* dequeue attempts that returned nothing */
+	uint64_t polls_hit;
+	uint64_t syscalls;
+	uint64_t syscall_pkts;  /* packets passed to sendmmsg */
+	uint64_t batch_hist[DIFI_PROF_HIST_BINS];
+};
+
+extern int g_prof_enabled;
+
+#ifdef DIFI_PROFILE
+#define DIFI_PROF_ON() unlikely(g_prof_enabled)
+#else
+#define DIFI_PROF_ON() 0
+#endif
+
+/* Single writer per struct: relaxed store keeps readers on other lcores tear-free
+ * without a locked add on the hot path. */
+static inline void difi_prof_add(uint64_t *ctr, uint64_t v)
+{
+	__atomic_store_n(ctr, *ctr + v, __ATOMIC_RELAXED);
+}
+
+/* Charge cycles since t0 to stage; returns the new timestamp for the next stage. */
+static inline uint64_t difi_prof_stage(struct difi_prof *p, enum difi_prof_stage st, uint64_t t0)
+{
+	uint64_t t = rte_rdtsc();
+	difi_prof_add(&p->cycles[st], t - t0);
+	return t;
+}
+
+static inline void difi_prof_batch(struct difi_prof *p, unsigned int n)
+{
+	unsigned int bin = 0;
+	while (bin < DIFI_PROF_HIST_BINS - 1 && (1u << bin) < n)
+		bin++;
+	difi_prof_add(&p->syscalls, 1);
+	difi_prof_add(&p->syscall_pkts, n);
+	difi_prof_add(&p->batch_hist[bin], 1);
+}
+
+/* Hook macros: t is a uint64_t the caller keeps across stages */
+#define DIFI_PROF_START(t) \
+	do { if (DIFI_PROF_ON()) (t) = rte_rdtsc(); } while (0)
+#define DIFI_PROF_STAGE(p, st, t) \
+	do { if (DIFI_PROF_ON()) (t) = difi_prof_stage((p), (st), (t)); } while (0)
+#define DIFI_PROF_COUNT(p, field, v) \
+	do { if (DIFI_PROF_ON()) difi_prof_add(&(p)->field, (v)); } while (0)
+#define DIFI_PROF_BATCH(p, n) \
+	do { if (DIFI_PROF_ON()) difi_prof_batch((p), (n)); } while (0)
+
+/* Copy p with relaxed loads (p may be written by another lcore). */
+void difi_prof_snapshot(const struct difi_prof *p, struct difi_prof *out);
+
+/* One periodic line: cycles per chunk per busy stage, idle share of the profiled cycles,
+ * empty-poll %, batch and syscall cost for the interval cur - prev. */
+void difi_prof_print_interval(const char *tag, const struct difi_prof *cur,
+	const struct difi_prof *prev);
+
+/* Final summary block: totals, share of busy cycles per stage, idle time, batch histogram. */
+void difi_prof_print_summary(const char *tag, const struct difi_prof *p, uint64_t tsc_hz);
+
+#endif /* DIFI_PROF_H */
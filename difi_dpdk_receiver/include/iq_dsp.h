@@ -0,0 +1,51 @@
+/**
+ * Optional per-stream DSP stage for difi_dpdk_receiver: NCO frequency shift
+ * plus polyphase FIR decimation on 8-bit interleaved I/Q.
+ *
+ * The shift is folded into the filter: taps are modulated to a complex
+ * band-pass (h[k] * e^{jwk}) and the NCO rotation is applied at the output
+ * rate, so the per-input-sample work is one complex MAC per tap phase.
+ * Inner loops use AVX2 or NEON when the compiler targets them, scalar otherwise.
+ */
+#ifndef IQ_DSP_H
+#define IQ_DSP_H
+
+#include <stdint.h>
+
+#define IQ_DSP_MAX_DECIM        16u
+#define IQ_DSP_TAPS_PER_PHASE   16u   /* FIR length = taps_per_phase * decim (complex taps) */
+#define IQ_DSP_BLOCK_SAMPLES    4096u /* input samples widened per inner pass (bounds work buffer) */
+
+struct iq_dsp_stream {
+	uint32_t decim;
+	uint32_t ntaps;        /* complex taps; multiple of 8 */
+	uint32_t phase;        /* NCO phase at the next output sample */
+	uint32_t phase_inc;    /* NCO increment per output sample (decim * input increment) */
+	uint32_t avail;        /* complex samples held in work[] */
+	int      rotate;       /* 0 when shift is 0 Hz (skip output NCO) */
+	int16_t *taps_re;      /* ntaps * 2: {Re g, -Im g} pairs, reversed, Q15 */
+	int16_t *taps_im;      /* ntaps * 2: {Im g,  Re g} pairs, reversed, Q15 */
+	int16_t *work;         /* widened interleaved I/Q: history + current block */
+	int16_t *poly;         /* AVX2 only: work[] split into decim polyphase branches */
+	uint32_t poly_len;     /* complex samples per polyphase branch */
+};
+
+/* Set up one stream: decim 1..IQ_DSP_MAX_DECIM, shift_hz = offset of the sub-band
+ * to bring to 0 Hz (|shift_hz| < sample_rate_hz / 2). Returns 0 on success, -1 on bad
+ * parameters or allocation failure. */
+int iq_dsp_stream_init(struct iq_dsp_stream *st, uint32_t decim, double shift_hz,
+	uint32_t sample_rate_hz);
+
+void iq_dsp_stream_free(struct iq_dsp_stream *st);
+
+/* Filter in_samples complex 8-bit samples from in, write decimated 8-bit I/Q to out.
+ * Filter and NCO state carry across calls, so input may be split at any sample
+ * boundary. Returns the number of complex samples written; in steady state this is
+ * in_samples / decim when in_samples is a multiple of decim. */
+uint32_t iq_dsp_process(struct iq_dsp_stream *st, const uint8_t *in, uint32_t in_samples,
+	uint8_t *out);
+
+/* Name of the compiled inner-loop implementation ("avx2", "neon" or "scalar"). */
+const char *iq_dsp_isa(void);
+
+#endif /* IQ_DSP_H */
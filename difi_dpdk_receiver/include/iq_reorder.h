@@ -0,0 +1,66 @@
+/**
+ * Per-stream reorder window for multi-producer ingress: chunks of one stream
+ * may be enqueued by several producer threads and reach the ring out of order.
+ * The drain pushes each chunk keyed on iq_chunk_hdr.seq and pops them back in
+ * sequence order. A missing sequence number is given up on when the window is
+ * full or after a timeout, so one lost chunk cannot stall the stream.
+ *
+ * Single-threaded (drain lcore only); no locking.
+ */
+#ifndef IQ_REORDER_H
+#define IQ_REORDER_H
+
+#include <stdint.h>
+
+#include <rte_mbuf.h>
+
+#define IQ_REORDER_MAX_WINDOW 64u
+
+/* iq_reorder_push results; on anything but HELD the caller still owns (frees) the mbuf */
+#define IQ_REORDER_HELD  0
+#define IQ_REORDER_LATE  1   /* seq already released or skipped */
+#define IQ_REORDER_DUP   2   /* seq already held */
+
+struct iq_reorder {
+	struct rte_mbuf *slot[IQ_REORDER_MAX_WINDOW];  /* indexed by seq % window */
+	struct rte_mbuf *overflow;   /* chunk beyond the window, admitted once next_seq advances */
+	uint64_t overflow_seq;
+	uint32_t window;
+	uint32_t held;               /* chunks in slot[] */
+	int      started;
+	uint64_t next_seq;           /* next sequence number to release */
+	uint64_t max_seq;            /* highest sequence number pushed */
+	uint64_t gap_tsc;            /* TSC when release first stalled on a missing seq (0 = not stalled) */
+	uint32_t late_run;           /* consecutive late pushes with increasing seq (restart detection) */
+	uint64_t last_late_seq;
+
+	uint64_t released;
+	uint64_t reordered;          /* chunks pushed after a higher seq */
+	uint64_t max_depth;          /* largest (max_seq - seq) among reordered chunks */
+	uint64_t max_held;           /* peak window occupancy */
+	uint64_t late;
+	uint64_t duplicates;
+	uint64_t skipped;            /* sequence numbers given up on (window full or timeout) */
+};
+
+/* window 1..IQ_REORDER_MAX_WINDOW. Returns 0, or -1 on a bad window. */
+int iq_reorder_init(struct iq_reorder *r, uint32_t window);
+
+/* Non-zero when the caller should stop pushing until chunks are popped. */
+static inline int iq_reorder_full(const struct iq_reorder *r)
+{
+	return r->overflow != NULL || r->held >= r->window;
+}
+
+/* Take m (sequence seq) into the window. Call only when !iq_reorder_full(r). */
+int iq_reorder_push(struct iq_reorder *r, struct rte_mbuf *m, uint64_t seq);
+
+/* Next chunk in sequence order, or NULL. When the next seq is missing, waits up to
+ * timeout_tsc (measured from the first stalled pop) before skipping it; skips at once
+ * when the window is full. */
+struct rte_mbuf *iq_reorder_pop(struct iq_reorder *r, uint64_t tsc_now, uint64_t timeout_tsc);
+
+/* Free everything still held; returns the number of chunks freed. */
+unsigned int iq_reorder_drain(struct iq_reorder *r);
+
+#endif /* IQ_REORDER_H */
@@ -4,10 +4,14 @@
  * a DIFI data header (zero-copy for payload), and sends DIFI over UDP.
  * Data: 8-bit IQ at 7.68 Msps, up to 16 streams.
  * Uses sendmmsg() to send one packet per stream in a single syscall (batch).
+ * Optional per-stream DSP (--dsp-decim / --dsp-shift): NCO shift + FIR decimation
+ * before send, so only the selected sub-band goes on the wire.
+ * --ingest runs the reverse direction: DIFI over UDP -> per-stream rings (difi_ingest.c).
  */
 #define _GNU_SOURCE
 
 #include <inttypes.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,11 +33,20 @@
 
 #include "common.h"
 #include "difi.h"
+#include "iq_dsp.h"
+#include "iq_reorder.h"
+#include "difi_ingest.h"
+#include "difi_prof.h"
 
 #define RING_SIZE         512
 #define MBUF_POOL_SIZE    4096
 #define MBUF_DATA_SIZE    65535
 
+/* Largest DIFI packet sent: one mbuf's data room, below the 65507-byte UDP/IPv4 limit
+ * and small enough for --ingest to receive each packet into a single mbuf. Chunks whose
+ * packet would be larger are split into g_pkts_per_chunk DIFI packets. */
+#define DIFI_MAX_PACKET_BYTES  (MBUF_DATA_SIZE - RTE_PKTMBUF_HEADROOM)
+
 #define DIFI_HEADER_BYTES  32
 
 /* Dedicated send core: pool of contiguous buffers for drain -> send_ring -> send worker.
@@ -42,15 +55,31 @@
 #define SEND_RING_SIZE    8192
 #define SEND_BATCH_MAX    16
 
+/* Single-thread path sendmmsg batch: messages and iovecs (header + one per chunk segment
+ * a packet spans). The batch is flushed early when either would overflow; a chained
+ * chunk must have fewer than DRAIN_IOV_MAX segments. */
+#define DRAIN_BATCH_MAX   64
+#define DRAIN_IOV_MAX     1024
+
+/* Context scheduler: pre-packed standard context packet per stream */
+#define CTX_PKT_MAX       256
+#define CTX_DEFAULT_INTERVAL_MS 1000
+/* --mp-ingress without a reorder window: chunks arrive out of order, so only a step this
+ * far behind the highest seq seen is taken as a producer restart (as in iq_reorder_push) */
+#define CTX_RESTART_BACKSTEP    (4u * IQ_REORDER_MAX_WINDOW)
+
 struct send_item {
 	uint8_t  *buf;
+	uint32_t  len;         /* bytes to send from buf */
 	uint16_t  stream_id;
+	uint8_t   is_context;  /* counted in g_ctx_sent instead of g_sent */
 };
 
 static struct send_item *g_send_pool;
+static struct send_item **g_chunk_items;  /* g_pkts_per_chunk send_items reserved per chunk */
 static struct rte_ring *g_pool_ring;   /* available send_items (send worker produces, drain consumes) */
 static struct rte_ring *g_send_ring;   /* to-send (drain produces, send worker consumes) */
-static uint32_t g_packet_len;          /* DIFI_HEADER_BYTES + g_payload_bytes for copy */
+static uint32_t g_packet_len;          /* DIFI_HEADER_BYTES + g_pkt_payload_bytes (one data packet) */
 
 /* Big-endian stores (used in hot path; no difi_fill_data_header_i8) */
 static inline void store_be32(uint8_t *p, uint32_t val)
@@ -84,6 +113,19 @@ static uint16_t g_dest_port     = 50000;
 static int      g_eob_on_exit   = 0;  /* send context packet with EOB on exit */
 static int      g_eos_on_exit   = 0;  /* send context packet with EOS on exit */
 static int      g_no_send       = 0;  /* if set, drain rings but do not send UDP (for bottleneck testing) */
+static uint32_t g_dsp_decim     = 1;  /* --dsp-decim: output rate = input rate / decim */
+static double   g_dsp_shift_hz[IQ_MAX_STREAMS];  /* --dsp-shift / --dsp-shift-stream: sub-band offset moved to 0 Hz */
+static double   g_dsp_shift_all_hz;                  /* --dsp-shift; applied after parsing to streams without an override */
+static int      g_dsp_shift_override[IQ_MAX_STREAMS];  /* --dsp-shift-stream given for the stream */
+static int      g_dsp_bench     = 0;  /* --dsp-bench: run DSP microbenchmark and exit */
+static int      g_ingest        = 0;  /* --ingest: receive DIFI over UDP into the stream rings */
+static char     g_bind_addr[64] = "0.0.0.0";
+static uint16_t g_bind_port     = 50000;
+static int      g_gro           = 0;  /* --gro: enable UDP_GRO on the ingest socket */
+static uint32_t g_context_interval_ms = CTX_DEFAULT_INTERVAL_MS;  /* --context-interval-ms: 0 = only on start/change */
+static int      g_mp_ingress    = 0;  /* --mp-ingress: stream rings accept several producers (MP enqueue) */
+static int      g_reorder_window = -1; /* --reorder-window: 0 = off; default 8 with --mp-ingress, else off */
+static uint32_t g_reorder_timeout_us = 1000;  /* --reorder-timeout-us: wait for a missing seq before skipping */
 
 static struct rte_ring *g_rings[IQ_MAX_STREAMS];
 
@@ -93,13 +135,28 @@ static struct sockaddr_in g_dest_saddr;
 /* Pre-calculated for fixed payload: packet size in 32-bit words */
 static uint16_t g_packet_size_words;
 static uint32_t g_payload_bytes;
-static uint32_t g_total_chunk_bytes;
+
+/* DSP stage: enabled when decimating or shifting any stream. Outbound payload/rate
+ * differ from the inbound chunk when enabled (DIFI headers and context use these). */
+static int      g_dsp_enabled;
+static struct iq_dsp_stream g_dsp[IQ_MAX_STREAMS];
+static uint8_t *g_dsp_out_bufs[IQ_MAX_STREAMS];  /* DSP output for the single-thread (iovec) path */
+static uint32_t g_out_payload_bytes;
+static uint32_t g_out_sample_rate_hz;
+static uint64_t g_dsp_delay_ps;   /* FIR group delay, (ntaps - 1) / 2 input samples; subtracted from DIFI timestamps */
+
+/* Chunk split: each chunk goes out as g_pkts_per_chunk DIFI packets of g_pkt_out_samples
+ * (1 unless the whole chunk would exceed DIFI_MAX_PACKET_BYTES) */
+static uint32_t g_pkts_per_chunk = 1;
+static uint32_t g_pkt_out_samples;
+static uint32_t g_pkt_payload_bytes;   /* outbound payload per packet */
+static uint32_t g_pkt_in_bytes;        /* chunk payload consumed per packet (x decim) */
 
 /* Pre-filled DIFI header: Class ID (12 bytes) and header word0 with seq=0 (4 bytes, host order) */
 static uint8_t  g_class_id_blob[12];
 static uint32_t g_word0_template;
 
-/* Pre-allocated DIFI header buffers (one per stream); used with sendmsg iovec to avoid touching mbuf payload */
+/* Pre-allocated DIFI header buffers (g_pkts_per_chunk headers per stream); used with sendmsg iovec to avoid touching mbuf payload */
 static uint8_t *g_mbuf_header_bufs[IQ_MAX_STREAMS];
 
 /* Per-stream stats: inbound = dequeued from rings, outbound = sent over UDP */
@@ -114,6 +171,29 @@ static uint64_t g_last_sent_total;
 static uint64_t g_start_tsc;  /* TSC at start of consumer loop (for duration) */
 static uint64_t g_tsc_in_send_interval;  /* TSC ticks spent in send_packet/send_packet_iov during current 1s interval (Step 3 bottleneck) */
 
+/* Context scheduler state (drain thread only). Packets are packed once per parameter
+ * change; emission only patches the 4-bit count and timestamp and rides in the data batches. */
+struct ctx_sched_stream {
+	uint8_t  pkt[CTX_PKT_MAX];
+	uint32_t len;            /* 0 if packing failed (stream gets no context) */
+	uint8_t  count;          /* context packet count, independent of data sequence */
+	int      changed;        /* emit before the next data packet */
+	uint64_t next_tsc;       /* next periodic emission */
+	int      seen;           /* a chunk was seen (for producer restart detection) */
+	uint64_t last_chunk_seq;
+};
+static struct ctx_sched_stream g_ctx[IQ_MAX_STREAMS];
+static uint64_t g_ctx_interval_tsc;           /* 0 = periodic emission off */
+static uint64_t g_ctx_sent[IQ_MAX_STREAMS];   /* context packets sent (not in g_sent) */
+
+/* Reorder window per stream (drain lcore only), enabled when g_reorder_window > 0 */
+static struct iq_reorder g_reorder[IQ_MAX_STREAMS];
+static uint64_t g_reorder_timeout_tsc;
+
+/* --profile: per-stage cycles, one struct per lcore (drain = main lcore, send = send worker) */
+static struct difi_prof g_prof_drain;
+static struct difi_prof g_prof_send;
+
 static int parse_app_args(int argc, char **argv)
 {
 	for (int i = 0; i < argc; i++) {
@@ -145,8 +225,54 @@ static int parse_app_args(int argc, char **argv)
 			g_eos_on_exit = 1;
 		} else if (strcmp(argv[i], "--no-send") == 0) {
 			g_no_send = 1;
+		} else if (strcmp(argv[i], "--dsp-decim") == 0 && i + 1 < argc) {
+			g_dsp_decim = (uint32_t)atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--dsp-shift") == 0 && i + 1 < argc) {
+			g_dsp_shift_all_hz = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--dsp-shift-stream") == 0 && i + 1 < argc) {
+			const char *arg = argv[++i];
+			const char *colon = strchr(arg, ':');
+			unsigned sid = (unsigned)atoi(arg);
+			if (colon && sid < IQ_MAX_STREAMS) {
+				g_dsp_shift_hz[sid] = atof(colon + 1);
+				g_dsp_shift_override[sid] = 1;
+			}
+		} else if (strcmp(argv[i], "--dsp-bench") == 0) {
+			g_dsp_bench = 1;
+		} else if (strcmp(argv[i], "--ingest") == 0) {
+			g_ingest = 1;
+		} else if (strcmp(argv[i], "--bind") == 0 && i + 1 < argc) {
+			const char *bind_arg = argv[++i];
+			const char *colon = strrchr(bind_arg, ':');
+			if (colon && colon != bind_arg) {
+				size_t host_len = (size_t)(colon - bind_arg);
+				if (host_len >= sizeof(g_bind_addr)) host_len = sizeof(g_bind_addr) - 1;
+				memcpy(g_bind_addr, bind_arg, host_len);
+				g_bind_addr[host_len] = '\0';
+				g_bind_port = (uint16_t)atoi(colon + 1);
+				if (g_bind_port == 0) g_bind_port = 50000;
+			} else {
+				snprintf(g_bind_addr, sizeof(g_bind_addr), "%s", bind_arg);
+			}
+		} else if (strcmp(argv[i], "--gro") == 0) {
+			g_gro = 1;
+		} else if (strcmp(argv[i], "--context-interval-ms") == 0 && i + 1 < argc) {
+			g_context_interval_ms = (uint32_t)atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--profile") == 0) {
+			g_prof_enabled = 1;
+		} else if (strcmp(argv[i], "--mp-ingress") == 0) {
+			g_mp_ingress = 1;
+		} else if (strcmp(argv[i], "--reorder-window") == 0 && i + 1 < argc) {
+			g_reorder_window = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--reorder-timeout-us") == 0 && i + 1 < argc) {
+			g_reorder_timeout_us = (uint32_t)atoi(argv[++i]);
 		}
 	}
+	/* Per-stream overrides win regardless of argument order */
+	for (unsigned k = 0; k < IQ_MAX_STREAMS; k++) {
+		if (!g_dsp_shift_override[k])
+			g_dsp_shift_hz[k] = g_dsp_shift_all_hz;
+	}
 	return 0;
 }
 
@@ -210,6 +336,43 @@ static inline void write_difi_header_variable(uint8_t *buf, uint32_t stream_id,
 	store_be64(buf + 24, ts_ps);
 }
 
+/* Header for packet k of a chunk: DIFI seq continues across the split (chunk seq *
+ * g_pkts_per_chunk + k) and the timestamp advances by the samples in packets 0..k-1. */
+static inline void write_difi_packet_header(uint8_t *buf, const struct iq_chunk_hdr *hdr, uint32_t k,
+	uint32_t ts_sec, uint64_t ts_ps)
+{
+	if (k > 0) {
+		uint64_t us_num = (uint64_t)k * g_pkt_out_samples * 1000000ULL;  /* samples * 1e6 */
+		ts_ps += us_num / g_out_sample_rate_hz * 1000000ULL
+			+ us_num % g_out_sample_rate_hz * 1000000ULL / g_out_sample_rate_hz;
+		ts_sec += (uint32_t)(ts_ps / 1000000000000ULL);
+		ts_ps %= 1000000000000ULL;
+	}
+	write_difi_header_variable(buf, (uint32_t)hdr->stream_id,
+		(uint8_t)((hdr->seq * g_pkts_per_chunk + k) & 0xF), ts_sec, ts_ps);
+}
+
+/* Split of out_samples into n equal packets of at most DIFI_MAX_PACKET_BYTES. n is the
+ * smallest power of two that fits when it divides evenly (--ingest realigns on those),
+ * else the smallest divisor that fits, but never more than twice the minimum packet
+ * count so packets stay at least about half full. 0 if no such split exists. */
+static uint32_t choose_pkts_per_chunk(uint32_t out_samples)
+{
+	const uint32_t max_samples = (DIFI_MAX_PACKET_BYTES - DIFI_HEADER_BYTES) / 2u;
+	uint32_t n_min = (out_samples + max_samples - 1u) / max_samples;
+	uint32_t n;
+
+	for (n = 1; n < n_min; n <<= 1)
+		;
+	if (out_samples % n == 0)
+		return n;
+	for (n = n_min; n <= 2u * n_min; n++) {
+		if (out_samples % n == 0)
+			return n;
+	}
+	return 0;
+}
+
 /* Send one DIFI packet (header already written in buf); buf is total_len bytes */
 static int send_packet(const uint8_t *buf, uint32_t total_len)
 {
@@ -226,7 +389,42 @@ static int send_packet(const uint8_t *buf, uint32_t total_len)
 	return 0;
 }
 
-/* Send one DIFI context packet per stream with optional EOB/EOS in SEI (on exit). */
+/* Standard context for one stream as it leaves the receiver: with DSP enabled the
+ * sample rate is the decimated rate, bandwidth is the FIR passband (0.8 x output
+ * rate) and the RF reference moves by the stream's shift. */
+static difi_result_t init_stream_context(difi_context_t *ctx, uint16_t s)
+{
+	uint64_t bandwidth_hz = (g_dsp_decim > 1) ? (uint64_t)g_out_sample_rate_hz * 4u / 5u
+	                                          : (uint64_t)g_out_sample_rate_hz;
+	uint64_t rf_ref_hz = (uint64_t)((int64_t)2400000000LL + (int64_t)llround(g_dsp_shift_hz[s]));
+
+	return difi_init_standard_context(
+		ctx,
+		(uint32_t)s,
+		0,                                    /* reference_point */
+		bandwidth_hz,                         /* bandwidth_hz */
+		0,                                    /* if_ref_hz */
+		rf_ref_hz,                            /* rf_ref_hz */
+		0,                                    /* if_band_offset_hz */
+		(int16_t)(-30.0 * 256),               /* reference_level_dbm */
+		(int16_t)(20.0 * 256),                /* gain_db */
+		(uint64_t)g_out_sample_rate_hz,       /* sample_rate_hz */
+		0, 0, 0,                              /* ts_adjust_ps, ts_cal_time_s, state_event_flags */
+		(uint16_t)DIFI_PAYLOAD_FORMAT_I8);
+}
+
+/* Write the 4-bit packet count into a packed context packet's header word 0; returns word 0 */
+static inline uint32_t ctx_set_count(uint8_t *pkt, uint8_t count)
+{
+	uint32_t word0 = ((uint32_t)pkt[0] << 24) | ((uint32_t)pkt[1] << 16)
+		| ((uint32_t)pkt[2] << 8) | (uint32_t)pkt[3];
+	word0 = (word0 & ~(0xFu << 16)) | ((uint32_t)(count & 0xF) << 16);
+	store_be32(pkt, word0);
+	return word0;
+}
+
+/* Send one DIFI context packet per stream with optional EOB/EOS in SEI (on exit). The packet
+ * count continues the stream's context count from the scheduler. */
 static void send_sei_context_packets_on_exit(void)
 {
 	uint8_t ctx_buf[256];
@@ -236,20 +434,7 @@ static void send_sei_context_packets_on_exit(void)
 	uint16_t s;
 
 	for (s = 0; s < g_streams; s++) {
-		uint32_t stream_id = (uint32_t)s;
-		res = difi_init_standard_context(
-			&ctx,
-			stream_id,
-			0,                                    /* reference_point */
-			(uint64_t)IQ_DEFAULT_SAMPLE_RATE_HZ,  /* bandwidth_hz */
-			0,                                    /* if_ref_hz */
-			2400000000ULL,                        /* rf_ref_hz */
-			0,                                    /* if_band_offset_hz */
-			(int16_t)(-30.0 * 256),               /* reference_level_dbm */
-			(int16_t)(20.0 * 256),                /* gain_db */
-			(uint64_t)IQ_DEFAULT_SAMPLE_RATE_HZ,  /* sample_rate_hz */
-			0, 0, 0,                              /* ts_adjust_ps, ts_cal_time_s, state_event_flags */
-			(uint16_t)DIFI_PAYLOAD_FORMAT_I8);
+		res = init_stream_context(&ctx, s);
 		if (res != DIFI_OK)
 			continue;
 		if (g_eob_on_exit)
@@ -261,40 +446,89 @@ static void send_sei_context_packets_on_exit(void)
 		res = difi_pack_context_class0(&ctx, ctx_buf, sizeof(ctx_buf), &len);
 		if (res != DIFI_OK)
 			continue;
+		ctx_set_count(ctx_buf, g_ctx[s].count);
+		g_ctx[s].count = (uint8_t)((g_ctx[s].count + 1u) & 0xF);
 		send_packet(ctx_buf, (uint32_t)len);
 	}
 }
 
-/* Send one standard context packet per stream at startup so difi_recv knows payload is 8-bit before first data. */
-static void send_startup_context_packets(void)
+/* (Re)pack stream s's context from the current parameters and emit it before the stream's
+ * next data packet. Call whenever anything init_stream_context() reads changes. */
+static void ctx_sched_mark_changed(uint16_t s)
 {
-	uint8_t ctx_buf[256];
 	difi_context_t ctx;
-	difi_result_t res;
-	size_t len;
+	size_t len = 0;
+
+	g_ctx[s].len = 0;
+	if (init_stream_context(&ctx, s) != DIFI_OK)
+		return;
+	if (difi_pack_context_class0(&ctx, g_ctx[s].pkt, sizeof(g_ctx[s].pkt), &len) != DIFI_OK)
+		return;
+	g_ctx[s].len = (uint32_t)len;
+	g_ctx[s].changed = 1;
+}
+
+/* Pack all streams; periodic emissions are staggered across the interval so streams do not
+ * all emit in the same drain pass. */
+static void ctx_sched_init(uint64_t tsc_now, uint64_t tsc_hz)
+{
 	uint16_t s;
 
+	g_ctx_interval_tsc = tsc_hz / 1000u * (uint64_t)g_context_interval_ms;
 	for (s = 0; s < g_streams; s++) {
-		uint32_t stream_id = (uint32_t)s;
-		res = difi_init_standard_context(
-			&ctx,
-			stream_id,
-			0,                                    /* reference_point */
-			(uint64_t)IQ_DEFAULT_SAMPLE_RATE_HZ,  /* bandwidth_hz */
-			0,                                    /* if_ref_hz */
-			2400000000ULL,                        /* rf_ref_hz */
-			0,                                    /* if_band_offset_hz */
-			(int16_t)(-30.0 * 256),               /* reference_level_dbm */
-			(int16_t)(20.0 * 256),                /* gain_db */
-			(uint64_t)IQ_DEFAULT_SAMPLE_RATE_HZ,  /* sample_rate_hz */
-			0, 0, 0,                              /* ts_adjust_ps, ts_cal_time_s, state_event_flags */
-			(uint16_t)DIFI_PAYLOAD_FORMAT_I8);
-		if (res != DIFI_OK)
-			continue;
-		res = difi_pack_context_class0(&ctx, ctx_buf, sizeof(ctx_buf), &len);
-		if (res != DIFI_OK)
-			continue;
-		send_packet(ctx_buf, (uint32_t)len);
+		memset(&g_ctx[s], 0, sizeof(g_ctx[s]));
+		ctx_sched_mark_changed(s);
+		g_ctx[s].next_tsc = tsc_now + g_ctx_interval_tsc * s / g_streams;
+	}
+	memset(g_ctx_sent, 0, sizeof(g_ctx_sent));
+}
+
+/* Called per validated chunk before its data packet is queued. Returns the context packet
+ * to send ahead of it (count and timestamp updated to match the data), or NULL. The caller
+ * calls ctx_sched_commit() once the packet is queued; otherwise it is retried next chunk. */
+static inline const uint8_t *ctx_sched_due(uint16_t s, uint64_t chunk_seq, uint64_t tsc_now,
+	uint32_t ts_sec, uint64_t ts_ps, uint32_t *len)
+{
+	struct ctx_sched_stream *c = &g_ctx[s];
+
+	/* Producer restarted (sequence went back): treat as a new stream instance. Unordered
+	 * MP rings only count a large step back and keep last_chunk_seq at the highest seq. */
+	if (c->seen && chunk_seq <= c->last_chunk_seq) {
+		if (!(g_mp_ingress && g_reorder_window == 0)
+				|| c->last_chunk_seq - chunk_seq > CTX_RESTART_BACKSTEP) {
+			ctx_sched_mark_changed(s);
+			c->last_chunk_seq = chunk_seq;
+		}
+	} else {
+		c->last_chunk_seq = chunk_seq;
+	}
+	c->seen = 1;
+
+	if (c->len == 0)
+		return NULL;
+	if (!c->changed && (g_ctx_interval_tsc == 0 || tsc_now < c->next_tsc))
+		return NULL;
+
+	uint32_t word0 = ctx_set_count(c->pkt, c->count);
+	/* Timestamp words follow the Class ID when TSI/TSF are present (same offsets as data) */
+	if ((word0 & 0x08000000u) && ((word0 >> 22) & 0x3u) && ((word0 >> 20) & 0x3u) && c->len >= DIFI_HEADER_BYTES) {
+		store_be32(c->pkt + 20, ts_sec);
+		store_be64(c->pkt + 24, ts_ps);
+	}
+	*len = c->len;
+	return c->pkt;
+}
+
+static inline void ctx_sched_commit(uint16_t s, uint64_t tsc_now)
+{
+	struct ctx_sched_stream *c = &g_ctx[s];
+
+	c->count = (uint8_t)((c->count + 1u) & 0xF);
+	c->changed = 0;
+	if (g_ctx_interval_tsc != 0) {
+		c->next_tsc += g_ctx_interval_tsc;
+		if (c->next_tsc <= tsc_now)  /* stream was idle: restart the period from now */
+			c->next_tsc = tsc_now + g_ctx_interval_tsc;
 	}
 }
 
@@ -327,6 +561,132 @@ static int send_packet_iov(const uint8_t *header, uint32_t header_len,
 	return 0;
 }
 
+/* Chunk checks shared by the direct and reorder paths. A single-segment chunk must fit
+ * its buffer. A chained chunk (nb_segs > 1) carries its header in the first segment, has
+ * exactly nb_segs segments each within its buffer, and their data_len add up to pkt_len =
+ * header + payload; with DSP on, every segment must hold whole samples. */
+static inline int chunk_valid(const struct rte_mbuf *m)
+{
+	const struct iq_chunk_hdr *hdr = rte_pktmbuf_mtod(m, const struct iq_chunk_hdr *);
+
+	if (m->nb_segs == 1) {
+		if (iq_total_chunk_bytes(g_payload_bytes) > (uint32_t)(m->buf_len - m->data_off))
+			return 0;
+	} else {
+		const uint32_t total = iq_total_chunk_bytes(g_payload_bytes);
+		uint32_t sum = 0, odd, nsegs = 0;
+
+		if (rte_pktmbuf_data_len(m) < sizeof(struct iq_chunk_hdr) || m->nb_segs >= DRAIN_IOV_MAX
+				|| rte_pktmbuf_pkt_len(m) != total)
+			return 0;
+		odd = rte_pktmbuf_data_len(m) - (uint32_t)sizeof(struct iq_chunk_hdr);
+		for (const struct rte_mbuf *seg = m; seg; seg = seg->next) {
+			if (++nsegs > m->nb_segs
+					|| rte_pktmbuf_data_len(seg) > (uint32_t)(seg->buf_len - seg->data_off))
+				return 0;
+			sum += rte_pktmbuf_data_len(seg);
+			if (seg != m)
+				odd |= rte_pktmbuf_data_len(seg);
+		}
+		if (nsegs != m->nb_segs || sum != total || (g_dsp_enabled && (odd & 1u)))
+			return 0;
+	}
+	return hdr->magic == IQ_CHUNK_MAGIC && hdr->version == IQ_CHUNK_VERSION
+		&& hdr->stream_id < g_streams && hdr->payload_len == g_payload_bytes;
+}
+
+/* Walks a chunk's payload, single-segment or chained, in contiguous pieces */
+struct chunk_cursor {
+	const struct rte_mbuf *seg;
+	uint32_t off;   /* next byte in seg */
+	uint32_t end;   /* end of payload in seg */
+};
+
+static inline void chunk_cursor_init(struct chunk_cursor *c, const struct rte_mbuf *m)
+{
+	c->seg = m;
+	c->off = (uint32_t)sizeof(struct iq_chunk_hdr);
+	/* Single-segment producers need not set data_len; trust payload_len there */
+	c->end = (m->nb_segs > 1) ? rte_pktmbuf_data_len(m) : iq_total_chunk_bytes(g_payload_bytes);
+}
+
+/* Up to want bytes of the next contiguous piece at *p; 0 at the end of the chunk */
+static inline uint32_t chunk_cursor_next(struct chunk_cursor *c, uint32_t want, const uint8_t **p)
+{
+	while (c->off >= c->end) {
+		c->seg = c->seg->next;
+		if (!c->seg)
+			return 0;
+		c->off = 0;
+		c->end = rte_pktmbuf_data_len(c->seg);
+	}
+	uint32_t n = c->end - c->off;
+	if (n > want)
+		n = want;
+	*p = rte_pktmbuf_mtod_offset(c->seg, const uint8_t *, c->off);
+	c->off += n;
+	return n;
+}
+
+/* Next len chunk payload bytes into dst, through the DSP stage when enabled.
+ * Returns the bytes written. */
+static uint32_t chunk_read(uint16_t s, struct chunk_cursor *c, uint32_t len, uint8_t *dst)
+{
+	const uint8_t *p;
+	uint32_t out = 0, n;
+
+	while (len > 0 && (n = chunk_cursor_next(c, len, &p)) > 0) {
+		if (g_dsp_enabled) {
+			out += iq_payload_bytes(iq_dsp_process(&g_dsp[s], p, n / 2u, dst + out));
+		} else {
+			memcpy(dst + out, p, n);
+			out += n;
+		}
+		len -= n;
+	}
+	return out;
+}
+
+/* --reorder-window: move what the producers have queued for stream s into its window
+ * and return the next chunk in sequence order (or NULL). Invalid, late and duplicate
+ * chunks are dropped here and counted as inbound errors. */
+static struct rte_mbuf *reorder_next(uint16_t s, uint64_t tsc_now)
+{
+	struct iq_reorder *r = &g_reorder[s];
+	void *obj;
+
+	while (!iq_reorder_full(r) && rte_ring_sc_dequeue(g_rings[s], &obj) == 0) {
+		struct rte_mbuf *m = (struct rte_mbuf *)obj;
+		const struct iq_chunk_hdr *hdr = rte_pktmbuf_mtod(m, const struct iq_chunk_hdr *);
+
+		g_dequeued[s]++;
+		if (!chunk_valid(m) || iq_reorder_push(r, m, hdr->seq) != IQ_REORDER_HELD) {
+			rte_pktmbuf_free(m);
+			g_inbound_errors++;
+		}
+	}
+	return iq_reorder_pop(r, tsc_now, g_reorder_timeout_tsc);
+}
+
+/* Sum reorder counters over all streams (max_* fields take the maximum) */
+static void reorder_totals(struct iq_reorder *t)
+{
+	memset(t, 0, sizeof(*t));
+	for (uint16_t s = 0; s < g_streams; s++) {
+		const struct iq_reorder *r = &g_reorder[s];
+		t->held += r->held;
+		t->released += r->released;
+		t->reordered += r->reordered;
+		t->late += r->late;
+		t->duplicates += r->duplicates;
+		t->skipped += r->skipped;
+		if (r->max_depth > t->max_depth)
+			t->max_depth = r->max_depth;
+		if (r->max_held > t->max_held)
+			t->max_held = r->max_held;
+	}
+}
+
 /* Dedicated send core: dequeue from g_send_ring, sendmmsg in batches, return to g_pool_ring */
 static int send_worker(void *arg)
 {
@@ -335,9 +695,11 @@ static int send_worker(void *arg)
 	static struct iovec iovs[SEND_BATCH_MAX];
 	static struct send_item *batch_items[SEND_BATCH_MAX];
 	unsigned int n;
+	uint64_t prof_tsc = 0;
 
 	while (!g_quit || rte_ring_count(g_send_ring) > 0) {
 		n = 0;
+		DIFI_PROF_START(prof_tsc);
 		while (n < SEND_BATCH_MAX) {
 			struct send_item *item;
 			if (rte_ring_sc_dequeue(g_send_ring, (void **)&item) != 0)
@@ -347,21 +709,33 @@ static int send_worker(void *arg)
 			msgvec[n].msg_hdr.msg_name = (void *)&g_dest_saddr;
 			msgvec[n].msg_hdr.msg_namelen = sizeof(g_dest_saddr);
 			iovs[n].iov_base = item->buf;
-			iovs[n].iov_len  = (size_t)g_packet_len;
+			iovs[n].iov_len  = (size_t)item->len;
 			msgvec[n].msg_hdr.msg_iov = &iovs[n];
 			msgvec[n].msg_hdr.msg_iovlen = 1;
 			n++;
 		}
 		if (n == 0) {
+			DIFI_PROF_STAGE(&g_prof_send, DIFI_PROF_IDLE, prof_tsc);
+			DIFI_PROF_COUNT(&g_prof_send, polls_empty, 1);
 			if (!g_quit)
 				continue;
 			break;
 		}
+		DIFI_PROF_STAGE(&g_prof_send, DIFI_PROF_DEQUEUE, prof_tsc);
+		DIFI_PROF_COUNT(&g_prof_send, polls_hit, 1);
+		DIFI_PROF_COUNT(&g_prof_send, chunks, n);
 		uint64_t tsc_before = rte_rdtsc();
 		int sent = sendmmsg(g_udp_sock, msgvec, n, 0);
 		__atomic_fetch_add(&g_tsc_in_send_interval, (rte_rdtsc() - tsc_before), __ATOMIC_RELAXED);
-		for (int i = 0; i < sent; i++)
-			__atomic_fetch_add(&g_sent[batch_items[i]->stream_id], 1, __ATOMIC_RELAXED);
+		DIFI_PROF_STAGE(&g_prof_send, DIFI_PROF_SYSCALL, prof_tsc);
+		DIFI_PROF_BATCH(&g_prof_send, n);
+		DIFI_USDT_PROBE2(sendmmsg, n, sent);
+		for (int i = 0; i < sent; i++) {
+			if (batch_items[i]->is_context)
+				__atomic_fetch_add(&g_ctx_sent[batch_items[i]->stream_id], 1, __ATOMIC_RELAXED);
+			else
+				__atomic_fetch_add(&g_sent[batch_items[i]->stream_id], 1, __ATOMIC_RELAXED);
+		}
 		if (sent >= 0 && sent < (int)n)
 			__atomic_fetch_add(&g_outbound_errors, (unsigned int)n - (unsigned int)sent, __ATOMIC_RELAXED);
 		else if (sent < 0)
@@ -370,7 +744,205 @@ static int send_worker(void *arg)
 			while (rte_ring_sp_enqueue(g_pool_ring, batch_items[i]) != 0)
 				;
 		}
+		DIFI_PROF_STAGE(&g_prof_send, DIFI_PROF_HANDOFF, prof_tsc);
+	}
+	return 0;
+}
+
+/* Single-thread path: sendmmsg batch built by the drain. Data iovecs point into the chunk
+ * mbuf segments (or the stream's DSP output); each chunk mbuf is freed after the send
+ * that carries its last packet. */
+static struct {
+	struct mmsghdr   msgvec[DRAIN_BATCH_MAX];
+	struct iovec     iov[DRAIN_IOV_MAX];
+	uint16_t         stream_ids[DRAIN_BATCH_MAX];
+	uint8_t          is_context[DRAIN_BATCH_MAX];
+	struct rte_mbuf *free_m[DRAIN_BATCH_MAX];
+	unsigned int     count;
+	unsigned int     iov_used;
+} g_batch;
+
+static inline int batch_has_room(unsigned int iovcnt)
+{
+	return g_batch.count < DRAIN_BATCH_MAX && g_batch.iov_used + iovcnt <= DRAIN_IOV_MAX;
+}
+
+/* Append one message made of the iovcnt iovecs filled in at g_batch.iov[g_batch.iov_used] */
+static inline void batch_add(uint16_t s, unsigned int iovcnt, int is_context)
+{
+	struct msghdr *mh = &g_batch.msgvec[g_batch.count].msg_hdr;
+
+	memset(mh, 0, sizeof(*mh));
+	mh->msg_name = (void *)&g_dest_saddr;
+	mh->msg_namelen = sizeof(g_dest_saddr);
+	mh->msg_iov = &g_batch.iov[g_batch.iov_used];
+	mh->msg_iovlen = iovcnt;
+	g_batch.stream_ids[g_batch.count] = s;
+	g_batch.is_context[g_batch.count] = (uint8_t)is_context;
+	g_batch.free_m[g_batch.count] = NULL;
+	g_batch.iov_used += iovcnt;
+	g_batch.count++;
+}
+
+/* Send the batch (unless --no-send), count the results, free the chunk mbufs */
+static void batch_flush(uint64_t *prof_tsc)
+{
+	unsigned int n = g_batch.count;
+
+	if (n > 0 && !g_no_send) {
+		uint64_t tsc_before = rte_rdtsc();
+		int sent = sendmmsg(g_udp_sock, g_batch.msgvec, n, 0);
+		__atomic_fetch_add(&g_tsc_in_send_interval, (rte_rdtsc() - tsc_before), __ATOMIC_RELAXED);
+		DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_SYSCALL, *prof_tsc);
+		DIFI_PROF_BATCH(&g_prof_drain, n);
+		DIFI_USDT_PROBE2(sendmmsg, n, sent);
+		for (int i = 0; i < sent; i++) {
+			if (g_batch.is_context[i])
+				g_ctx_sent[g_batch.stream_ids[i]]++;
+			else
+				g_sent[g_batch.stream_ids[i]]++;
+		}
+		if (sent >= 0 && (unsigned int)sent < n)
+			g_outbound_errors += n - (unsigned int)sent;
+		else if (sent < 0)
+			g_outbound_errors += n;
+	}
+	for (unsigned int i = 0; i < n; i++) {
+		if (g_batch.free_m[i])
+			rte_pktmbuf_free(g_batch.free_m[i]);
+	}
+	g_batch.count = 0;
+	g_batch.iov_used = 0;
+	DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HANDOFF, *prof_tsc);
+}
+
+/* --dsp-bench: run the configured DSP over synthetic chunks for every stream and report
+ * cycles per input sample and the share of one core needed to keep up in real time. */
+static void run_dsp_bench(uint32_t sample_rate_hz, uint32_t samples_per_chunk, uint64_t tsc_hz)
+{
+	const unsigned iters = 200;
+	struct iq_dsp_stream st[IQ_MAX_STREAMS];
+	uint8_t *in = malloc((size_t)g_payload_bytes);
+	uint8_t *out = malloc((size_t)g_payload_bytes);
+	uint16_t s;
+
+	if (!in || !out)
+		rte_exit(EXIT_FAILURE, "malloc dsp bench buffers failed\n");
+	for (uint32_t i = 0; i < g_payload_bytes; i++)
+		in[i] = iq_payload_byte_at(0, 0, i);
+	for (s = 0; s < g_streams; s++) {
+		if (iq_dsp_stream_init(&st[s], g_dsp_decim, g_dsp_shift_hz[s], sample_rate_hz) != 0)
+			rte_exit(EXIT_FAILURE, "DSP init failed for stream %u\n", (unsigned)s);
+		iq_dsp_process(&st[s], in, samples_per_chunk, out);  /* warm caches and filter history */
+	}
+
+	uint64_t tsc_before = rte_rdtsc();
+	for (unsigned it = 0; it < iters; it++)
+		for (s = 0; s < g_streams; s++)
+			iq_dsp_process(&st[s], in, samples_per_chunk, out);
+	uint64_t cycles = rte_rdtsc() - tsc_before;
+
+	double samples = (double)iters * (double)g_streams * (double)samples_per_chunk;
+	double cps = (double)cycles / samples;
+	double msps_per_core = (double)tsc_hz / cps / 1e6;
+	double core_pct = 100.0 * cps * (double)sample_rate_hz * (double)g_streams / (double)tsc_hz;
+	printf("DSP bench (%s): decim=%u streams=%u samples_per_chunk=%u taps=%u\n",
+		iq_dsp_isa(), (unsigned)g_dsp_decim, (unsigned)g_streams, (unsigned)samples_per_chunk,
+		(unsigned)st[0].ntaps);
+	printf("  %.2f cycles/sample (TSC), %.1f Msps per core\n", cps, msps_per_core);
+	printf("  real-time %u x %.2f Msps needs %.1f%% of one core%s\n",
+		(unsigned)g_streams, (double)sample_rate_hz / 1e6, core_pct,
+		core_pct < 100.0 ? "" : " (NOT real-time)");
+
+	for (s = 0; s < g_streams; s++)
+		iq_dsp_stream_free(&st[s]);
+	free(in);
+	free(out);
+}
+
+/* --ingest: receive DIFI on g_bind_addr:g_bind_port into the per-stream rings until SIGINT.
+ * Consumers (e.g. module_b) attach as secondary and drain the rings as usual. */
+static int run_ingest(struct rte_mempool *pool, uint64_t tsc_hz)
+{
+	static struct difi_ingest ing;
+	uint64_t last_dgrams = 0, last_bytes = 0, last_chunks = 0;
+	uint16_t s;
+
+	if (difi_ingest_open(&ing, g_bind_addr, g_bind_port, g_gro, pool, g_rings, g_streams,
+			g_payload_bytes) != 0)
+		return -1;
+	printf("difi_dpdk_receiver (primary, ingest): streams=%u payload_bytes=%u bind=%s:%u%s\n",
+		(unsigned)g_streams, (unsigned)g_payload_bytes, g_bind_addr, (unsigned)g_bind_port,
+		ing.gro ? " gro" : "");
+
+	uint64_t start_tsc = rte_rdtsc();
+	uint64_t last_tsc = start_tsc;
+	while (!g_quit) {
+		difi_ingest_poll(&ing);
+
+		uint64_t tsc_now = rte_rdtsc();
+		if (tsc_now - last_tsc >= tsc_hz) {
+			uint64_t chunks = 0, lost = 0;
+			for (s = 0; s < g_streams; s++) {
+				chunks += ing.st[s].chunks;
+				lost += ing.st[s].seq_lost;
+			}
+			double sec = (double)(tsc_now - last_tsc) / (double)tsc_hz;
+			printf("DIFI INGEST: rx %" PRIu64 "/s (%.2f Mbps), chunks %" PRIu64 "/s, seq_lost %" PRIu64
+				" hdr_err %" PRIu64 " len_err %" PRIu64 " ring_full %" PRIu64 " no_mbuf %" PRIu64 "\n",
+				(uint64_t)((double)(ing.rx_datagrams - last_dgrams) / sec),
+				(double)(ing.rx_bytes - last_bytes) * 8.0 / 1e6 / sec,
+				(uint64_t)((double)(chunks - last_chunks) / sec),
+				lost, ing.hdr_errors, ing.len_errors, ing.ring_full, ing.no_mbuf);
+			last_tsc = tsc_now;
+			last_dgrams = ing.rx_datagrams;
+			last_bytes = ing.rx_bytes;
+			last_chunks = chunks;
+		}
 	}
+
+	{
+		uint64_t chunks = 0, packets = 0, lost = 0, dups = 0, drops = 0, ctx = 0;
+		for (s = 0; s < g_streams; s++) {
+			chunks += ing.st[s].chunks;
+			packets += ing.st[s].packets;
+			lost += ing.st[s].seq_lost;
+			dups += ing.st[s].duplicates;
+			drops += ing.st[s].reasm_drops;
+			ctx += ing.st[s].ctx_packets;
+		}
+		double duration_sec = (double)(rte_rdtsc() - start_tsc) / (double)tsc_hz;
+		double mbps = (duration_sec > 0.0) ? ((double)ing.rx_bytes * 8.0 / 1e6 / duration_sec) : 0.0;
+		double pps = (duration_sec > 0.0) ? ((double)ing.rx_datagrams / duration_sec) : 0.0;
+
+		printf("\n=== difi_dpdk_receiver ingest final ===\n");
+		printf("Duration:         %.3f s\n\n", duration_sec);
+		printf("--- Inbound (from network, recvmmsg) ---\n");
+		printf("Datagrams:        %" PRIu64 " in %" PRIu64 " bursts (%.1f/burst)\n", ing.rx_datagrams,
+			ing.rx_calls, ing.rx_calls ? (double)ing.rx_datagrams / (double)ing.rx_calls : 0.0);
+		printf("Data packets:     %" PRIu64 ", context %" PRIu64 ", other %" PRIu64 "\n",
+			packets, ctx, ing.other_packets);
+		printf("Throughput:       %.1f datagrams/s, %.2f Mbps (UDP payload)\n", pps, mbps);
+		printf("Errors:           hdr %" PRIu64 ", len %" PRIu64 ", seq lost %" PRIu64 ", duplicates %" PRIu64 "\n\n",
+			ing.hdr_errors, ing.len_errors, lost, dups);
+		printf("--- Outbound (to consumers, ring enqueue) ---\n");
+		printf("Chunks:           %" PRIu64 "\n", chunks);
+		printf("Dropped:          ring full %" PRIu64 ", no mbuf %" PRIu64 ", partial chunks %" PRIu64 "\n",
+			ing.ring_full, ing.no_mbuf, drops);
+		if (g_streams <= 16) {
+			printf("Per-stream packets:  ");
+			for (s = 0; s < g_streams; s++)
+				printf("%" PRIu64 "%s", ing.st[s].packets, (s + 1 < g_streams) ? ", " : "\n");
+			printf("Per-stream chunks:   ");
+			for (s = 0; s < g_streams; s++)
+				printf("%" PRIu64 "%s", ing.st[s].chunks, (s + 1 < g_streams) ? ", " : "\n");
+			printf("Per-stream seq lost: ");
+			for (s = 0; s < g_streams; s++)
+				printf("%" PRIu64 "%s", ing.st[s].seq_lost, (s + 1 < g_streams) ? ", " : "\n");
+		}
+	}
+
+	difi_ingest_close(&ing);
 	return 0;
 }
 
@@ -400,30 +972,68 @@ int main(int argc, char **argv)
 		rte_exit(EXIT_FAILURE, "rte_eal_init failed\n");
 	if (app_argv)
 		parse_app_args(app_argc, app_argv);
+#ifndef DIFI_PROFILE
+	if (g_prof_enabled) {
+		printf("--profile ignored: built without DIFI_PROFILE\n");
+		g_prof_enabled = 0;
+	}
+#endif
 
 	if (g_samples_per_chunk > 0)
 		samples_per_chunk = g_samples_per_chunk;
 	else
 		samples_per_chunk = iq_samples_per_chunk(sample_rate_hz, g_chunk_ms);
 	g_payload_bytes   = iq_payload_bytes(samples_per_chunk);
-	g_total_chunk_bytes = iq_total_chunk_bytes(g_payload_bytes);
+
+	if (g_dsp_decim < 1 || g_dsp_decim > IQ_DSP_MAX_DECIM)
+		rte_exit(EXIT_FAILURE, "--dsp-decim must be 1..%u\n", (unsigned)IQ_DSP_MAX_DECIM);
+	if (samples_per_chunk % g_dsp_decim != 0)
+		rte_exit(EXIT_FAILURE, "samples_per_chunk %u is not a multiple of --dsp-decim %u\n",
+			(unsigned)samples_per_chunk, (unsigned)g_dsp_decim);
+	if (g_reorder_window < 0)
+		g_reorder_window = g_mp_ingress ? 8 : 0;
+	if (g_reorder_window > (int)IQ_REORDER_MAX_WINDOW)
+		rte_exit(EXIT_FAILURE, "--reorder-window must be 0..%u\n", (unsigned)IQ_REORDER_MAX_WINDOW);
+	if (g_reorder_window >= (int)RING_SIZE)
+		rte_exit(EXIT_FAILURE, "--reorder-window must be below the ring size %u\n", (unsigned)RING_SIZE);
+
+	g_dsp_enabled = (g_dsp_decim > 1);
+	for (s = 0; s < g_streams; s++) {
+		if (fabs(g_dsp_shift_hz[s]) >= (double)sample_rate_hz / 2.0)
+			rte_exit(EXIT_FAILURE, "stream %u shift %.0f Hz outside +/- %u Hz\n",
+				(unsigned)s, g_dsp_shift_hz[s], (unsigned)(sample_rate_hz / 2));
+		if (g_dsp_shift_hz[s] != 0.0)
+			g_dsp_enabled = 1;
+	}
+	g_out_sample_rate_hz = sample_rate_hz / g_dsp_decim;
+	g_out_payload_bytes  = iq_payload_bytes(samples_per_chunk / g_dsp_decim);
+
+	g_pkts_per_chunk = choose_pkts_per_chunk(samples_per_chunk / g_dsp_decim);
+	if (g_pkts_per_chunk == 0)
+		rte_exit(EXIT_FAILURE, "cannot split %u output samples per chunk into equal DIFI packets of %u..%u B; "
+			"use a chunk size with a small divisor (e.g. a multiple of a power of two)\n",
+			(unsigned)(samples_per_chunk / g_dsp_decim), (unsigned)(DIFI_MAX_PACKET_BYTES / 2u),
+			(unsigned)DIFI_MAX_PACKET_BYTES);
+	g_pkt_out_samples   = samples_per_chunk / g_dsp_decim / g_pkts_per_chunk;
+	g_pkt_payload_bytes = iq_payload_bytes(g_pkt_out_samples);
+	g_pkt_in_bytes      = iq_payload_bytes(g_pkt_out_samples * g_dsp_decim);
 
 	/* Pre-calculate DIFI packet size in 32-bit words */
 	{
-		size_t packet_size_bytes = DIFI_HEADER_BYTES + (size_t)g_payload_bytes;
+		size_t packet_size_bytes = DIFI_HEADER_BYTES + (size_t)g_pkt_payload_bytes;
 		g_packet_size_words = (uint16_t)((packet_size_bytes + 3u) / 4u);
 	}
 	init_difi_header_templates();
 
 	tsc_hz = rte_get_tsc_hz();
 
-	if (g_total_chunk_bytes > MBUF_DATA_SIZE) {
-		rte_exit(EXIT_FAILURE,
-			"Chunk size %u > mbuf data size %u; reduce --chunk-ms or --samples-per-chunk\n",
-			(unsigned)g_total_chunk_bytes, (unsigned)MBUF_DATA_SIZE);
+	if (g_dsp_bench) {
+		run_dsp_bench(sample_rate_hz, samples_per_chunk, tsc_hz);
+		rte_eal_cleanup();
+		return 0;
 	}
 
-	if (!g_no_send) {
+	if (!g_no_send && !g_ingest) {
 		g_udp_sock = open_udp_socket();
 		if (g_udp_sock < 0)
 			rte_exit(EXIT_FAILURE, "Failed to open UDP socket\n");
@@ -432,40 +1042,69 @@ int main(int argc, char **argv)
 	}
 
 	iq_mempool_name(g_file_prefix, name, sizeof(name));
-	if (!rte_pktmbuf_pool_create(name, MBUF_POOL_SIZE, 0, 0,
-			MBUF_DATA_SIZE, rte_socket_id()))
+	struct rte_mempool *mbuf_pool = rte_pktmbuf_pool_create(name, MBUF_POOL_SIZE, 0, 0,
+			MBUF_DATA_SIZE, rte_socket_id());
+	if (!mbuf_pool)
 		rte_exit(EXIT_FAILURE, "mempool create failed: %s\n", rte_strerror(rte_errno));
-	/* Pre-allocate and pre-fill one DIFI header buffer per stream for zero-copy sendmsg (no write into mbuf) */
-	for (s = 0; s < g_streams; s++) {
-		g_mbuf_header_bufs[s] = malloc(DIFI_HEADER_BYTES);
-		if (!g_mbuf_header_bufs[s])
-			rte_exit(EXIT_FAILURE, "malloc mbuf_header_buf stream %u failed\n", (unsigned)s);
-		uint8_t *b = g_mbuf_header_bufs[s];
-		store_be32(b + 0, g_word0_template);
-		store_be32(b + 4, (uint32_t)s);
-		memcpy(b + 8, g_class_id_blob, 12);
-		memset(b + 20, 0, 12);
-	}
 
 	for (s = 0; s < g_streams; s++) {
 		iq_ring_name(g_file_prefix, s, name, sizeof(name));
 		g_rings[s] = rte_ring_create(name, RING_SIZE, rte_socket_id(),
-			RING_F_SP_ENQ | RING_F_SC_DEQ);
+			g_mp_ingress ? RING_F_SC_DEQ : (RING_F_SP_ENQ | RING_F_SC_DEQ));
 		if (!g_rings[s])
 			rte_exit(EXIT_FAILURE, "ring create %s failed: %s\n", name, rte_strerror(rte_errno));
 	}
 
-	g_packet_len = DIFI_HEADER_BYTES + g_payload_bytes;
+	/* Ingest mode: this process is the ring producer; no DIFI send path */
+	if (g_ingest) {
+		ret = run_ingest(mbuf_pool, tsc_hz);
+		rte_eal_cleanup();
+		return (ret == 0) ? 0 : EXIT_FAILURE;
+	}
+
+	/* Pre-allocate and pre-fill the DIFI headers of one chunk per stream for zero-copy sendmsg (no write into mbuf) */
+	for (s = 0; s < g_streams; s++) {
+		g_mbuf_header_bufs[s] = malloc((size_t)DIFI_HEADER_BYTES * g_pkts_per_chunk);
+		if (!g_mbuf_header_bufs[s])
+			rte_exit(EXIT_FAILURE, "malloc mbuf_header_buf stream %u failed\n", (unsigned)s);
+		for (uint32_t k = 0; k < g_pkts_per_chunk; k++) {
+			uint8_t *b = g_mbuf_header_bufs[s] + k * DIFI_HEADER_BYTES;
+			store_be32(b + 0, g_word0_template);
+			store_be32(b + 4, (uint32_t)s);
+			memcpy(b + 8, g_class_id_blob, 12);
+			memset(b + 20, 0, 12);
+		}
+	}
+
+	if (g_dsp_enabled) {
+		for (s = 0; s < g_streams; s++) {
+			if (iq_dsp_stream_init(&g_dsp[s], g_dsp_decim, g_dsp_shift_hz[s], sample_rate_hz) != 0)
+				rte_exit(EXIT_FAILURE, "DSP init failed for stream %u\n", (unsigned)s);
+			g_dsp_out_bufs[s] = malloc((size_t)g_out_payload_bytes);
+			if (!g_dsp_out_bufs[s])
+				rte_exit(EXIT_FAILURE, "malloc dsp_out_buf stream %u failed\n", (unsigned)s);
+		}
+		/* The causal FIR centres output m on input m * decim - (ntaps - 1) / 2 */
+		g_dsp_delay_ps = (uint64_t)(g_dsp[0].ntaps - 1u) * 1000000000000ULL / (2ULL * sample_rate_hz);
+	}
+
+	g_packet_len = DIFI_HEADER_BYTES + g_pkt_payload_bytes;
 
 	unsigned int n_lcores = rte_lcore_count();
 	int use_dedicated_send = (n_lcores >= 2 && !g_no_send);
 
 	if (use_dedicated_send) {
+		/* A chunk's packets are reserved together, plus one item for its context packet */
+		if (g_pkts_per_chunk + 1u > SEND_POOL_SIZE)
+			rte_exit(EXIT_FAILURE, "chunk needs %u send buffers, pool has %u; reduce the chunk size\n",
+				(unsigned)(g_pkts_per_chunk + 1u), (unsigned)SEND_POOL_SIZE);
+		g_chunk_items = calloc(g_pkts_per_chunk, sizeof(*g_chunk_items));
 		g_send_pool = calloc(SEND_POOL_SIZE, sizeof(struct send_item));
-		if (!g_send_pool)
+		if (!g_send_pool || !g_chunk_items)
 			rte_exit(EXIT_FAILURE, "malloc send_pool failed\n");
+		size_t send_buf_len = (g_packet_len > CTX_PKT_MAX) ? (size_t)g_packet_len : CTX_PKT_MAX;
 		for (unsigned int i = 0; i < SEND_POOL_SIZE; i++) {
-			g_send_pool[i].buf = malloc((size_t)g_packet_len);
+			g_send_pool[i].buf = malloc(send_buf_len);
 			if (!g_send_pool[i].buf)
 				rte_exit(EXIT_FAILURE, "malloc send_pool[%u].buf failed\n", i);
 		}
@@ -495,16 +1134,35 @@ int main(int argc, char **argv)
 	g_last_dequeued_total = 0;
 	g_last_sent_total = 0;
 
-	printf("difi_dpdk_receiver (primary): streams=%u samples_per_chunk=%u dest=%s:%u%s%s%s%s\n",
+	printf("difi_dpdk_receiver (primary): streams=%u samples_per_chunk=%u dest=%s:%u ctx-interval=%ums%s%s%s%s%s\n",
 		(unsigned)g_streams, (unsigned)samples_per_chunk, g_dest_addr, (unsigned)g_dest_port,
+		(unsigned)g_context_interval_ms,
 		g_eob_on_exit ? " eob-on-exit" : "",
 		g_eos_on_exit ? " eos-on-exit" : "",
 		g_no_send ? " NO-SEND (drain only)" : "",
-		use_dedicated_send ? " dedicated-send" : "");
-
-	/* Send one standard context per stream so difi_recv knows payload is 8-bit before first data */
-	if (g_udp_sock >= 0)
-		send_startup_context_packets();
+		use_dedicated_send ? " dedicated-send" : "",
+		g_prof_enabled ? " profile" : "");
+	if (g_mp_ingress || g_reorder_window > 0)
+		printf("Ingress: %s rings, reorder window %d (timeout %u us)\n",
+			g_mp_ingress ? "multi-producer" : "single-producer", g_reorder_window,
+			(unsigned)g_reorder_timeout_us);
+	if (g_pkts_per_chunk > 1)
+		printf("Chunk split: %u DIFI packets per chunk, %u B payload each\n",
+			(unsigned)g_pkts_per_chunk, (unsigned)g_pkt_payload_bytes);
+	if (g_dsp_enabled)
+		printf("DSP (%s): decim=%u out_rate=%u Hz out_payload=%u B taps=%u delay=%.3f us\n",
+			iq_dsp_isa(), (unsigned)g_dsp_decim, (unsigned)g_out_sample_rate_hz,
+			(unsigned)g_out_payload_bytes, (unsigned)g_dsp[0].ntaps, (double)g_dsp_delay_ps / 1e6);
+
+	/* Context per stream goes out ahead of its first data packet (so difi_recv knows payload
+	 * is 8-bit), then every --context-interval-ms and on parameter change, inside the data batches */
+	ctx_sched_init(rte_rdtsc(), tsc_hz);
+
+	if (g_reorder_window > 0) {
+		g_reorder_timeout_tsc = tsc_hz / 1000000u * (uint64_t)g_reorder_timeout_us;
+		for (s = 0; s < g_streams; s++)
+			iq_reorder_init(&g_reorder[s], (uint32_t)g_reorder_window);
+	}
 
 	__atomic_store_n(&g_tsc_in_send_interval, 0, __ATOMIC_RELAXED);
 
@@ -516,92 +1174,149 @@ int main(int argc, char **argv)
 		rte_eal_remote_launch(send_worker, NULL, send_lcore_id);
 	}
 
-	/* Batch for single-thread path (no dedicated send) */
-	static struct mmsghdr msgvec[IQ_MAX_STREAMS];
-	static struct iovec iovs[IQ_MAX_STREAMS][2];
-	static uint16_t batch_stream_ids[IQ_MAX_STREAMS];
-	static void *batch_objs[IQ_MAX_STREAMS];
-
 	/* Consumer loop */
 	while (!g_quit) {
-		unsigned int batch_count = 0;
+		uint64_t tsc_now = rte_rdtsc();
+		uint64_t prof_tsc = tsc_now;  /* profiler: cycles since this mark go to the next stage named */
 
-		for (s = 0; s < g_streams && batch_count < IQ_MAX_STREAMS; s++) {
+		for (s = 0; s < g_streams; s++) {
 			void *obj;
-			if (rte_ring_sc_dequeue(g_rings[s], &obj) != 0)
-				continue;
-
-			g_dequeued[s]++;
+			if (g_reorder_window > 0) {
+				obj = reorder_next(s, tsc_now);
+				if (!obj) {
+					DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_IDLE, prof_tsc);
+					DIFI_PROF_COUNT(&g_prof_drain, polls_empty, 1);
+					continue;
+				}
+			} else {
+				if (rte_ring_sc_dequeue(g_rings[s], &obj) != 0) {
+					DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_IDLE, prof_tsc);
+					DIFI_PROF_COUNT(&g_prof_drain, polls_empty, 1);
+					continue;
+				}
+				g_dequeued[s]++;
+			}
+			DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_DEQUEUE, prof_tsc);
+			DIFI_PROF_COUNT(&g_prof_drain, polls_hit, 1);
 
 			{
 				struct rte_mbuf *chunk_mbuf = (struct rte_mbuf *)obj;
 				struct iq_chunk_hdr *hdr = rte_pktmbuf_mtod(chunk_mbuf, struct iq_chunk_hdr *);
 
-				if (hdr->magic != IQ_CHUNK_MAGIC || hdr->version != IQ_CHUNK_VERSION) {
-					rte_pktmbuf_free(chunk_mbuf);
-					g_inbound_errors++; continue;
-				}
-				if (hdr->stream_id >= g_streams || hdr->payload_len != g_payload_bytes) {
+				/* Chunks released by the reorder window were validated by reorder_next() */
+				if (g_reorder_window == 0 && !chunk_valid(chunk_mbuf)) {
 					rte_pktmbuf_free(chunk_mbuf);
+					DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_VALIDATE, prof_tsc);
 					g_inbound_errors++; continue;
 				}
+				DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_VALIDATE, prof_tsc);
+				DIFI_PROF_COUNT(&g_prof_drain, chunks, 1);
+				DIFI_USDT_PROBE2(chunk, s, hdr->seq);
 
-				uint8_t *payload_ptr = rte_pktmbuf_mtod(chunk_mbuf, uint8_t *) + sizeof(struct iq_chunk_hdr);
-				uint32_t ts_sec;
+				struct chunk_cursor cur;
+				uint32_t ts_sec, k;
 				uint64_t ts_ps;
+				uint8_t *hdr_bufs = g_mbuf_header_bufs[s];
+				chunk_cursor_init(&cur, chunk_mbuf);
 				timestamp_ns_to_difi(hdr->timestamp_ns, &ts_sec, &ts_ps);
-				write_difi_header_variable(g_mbuf_header_bufs[s], (uint32_t)hdr->stream_id,
-					(uint8_t)(hdr->seq & 0xF), ts_sec, ts_ps);
+				if (g_dsp_delay_ps > 0) {
+					if (ts_ps < g_dsp_delay_ps) {
+						ts_ps += 1000000000000ULL;
+						ts_sec--;
+					}
+					ts_ps -= g_dsp_delay_ps;
+				}
+				for (k = 0; k < g_pkts_per_chunk; k++)
+					write_difi_packet_header(hdr_bufs + k * DIFI_HEADER_BYTES, hdr, k, ts_sec, ts_ps);
+
+				uint32_t ctx_len = 0;
+				const uint8_t *ctx_pkt = g_no_send ? NULL
+					: ctx_sched_due(s, hdr->seq, tsc_now, ts_sec, ts_ps, &ctx_len);
+				DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HEADER, prof_tsc);
 
 				if (use_dedicated_send) {
 					struct send_item *item;
-					if (rte_ring_sc_dequeue(g_pool_ring, (void **)&item) == 0) {
-						memcpy(item->buf, g_mbuf_header_bufs[s], DIFI_HEADER_BYTES);
-						memcpy(item->buf + DIFI_HEADER_BYTES, payload_ptr, (size_t)g_payload_bytes);
+					if (ctx_pkt && rte_ring_sc_dequeue(g_pool_ring, (void **)&item) == 0) {
+						memcpy(item->buf, ctx_pkt, ctx_len);
+						item->len = ctx_len;
 						item->stream_id = s;
+						item->is_context = 1;
 						while (rte_ring_sp_enqueue(g_send_ring, item) != 0)
 							;
-					} else
+						ctx_sched_commit(s, tsc_now);
+					}
+					/* One send_item per DIFI packet, all reserved up front so the chunk is sent or
+					 * dropped as a unit; the copy (or DSP) gathers the chunk segments */
+					if (rte_ring_sc_dequeue_bulk(g_pool_ring, (void **)g_chunk_items,
+							g_pkts_per_chunk, NULL) == 0) {
 						g_inbound_errors++;
+						rte_pktmbuf_free(chunk_mbuf);
+						DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HANDOFF, prof_tsc);
+						continue;
+					}
+					DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HANDOFF, prof_tsc);
+					for (k = 0; k < g_pkts_per_chunk; k++) {
+						item = g_chunk_items[k];
+						memcpy(item->buf, hdr_bufs + k * DIFI_HEADER_BYTES, DIFI_HEADER_BYTES);
+						chunk_read(s, &cur, g_pkt_in_bytes, item->buf + DIFI_HEADER_BYTES);
+						DIFI_PROF_STAGE(&g_prof_drain, g_dsp_enabled ? DIFI_PROF_DSP : DIFI_PROF_COPY, prof_tsc);
+						item->len = g_packet_len;
+						item->stream_id = s;
+						item->is_context = 0;
+						while (rte_ring_sp_enqueue(g_send_ring, item) != 0)
+							;
+					}
 					rte_pktmbuf_free(chunk_mbuf);
+					DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HANDOFF, prof_tsc);
 				} else {
-					batch_stream_ids[batch_count] = s;
-					batch_objs[batch_count] = (void *)chunk_mbuf;
-					memset(&msgvec[batch_count].msg_hdr, 0, sizeof(struct msghdr));
-					msgvec[batch_count].msg_hdr.msg_name = (void *)&g_dest_saddr;
-					msgvec[batch_count].msg_hdr.msg_namelen = sizeof(g_dest_saddr);
-					iovs[batch_count][0].iov_base = g_mbuf_header_bufs[s];
-					iovs[batch_count][0].iov_len  = DIFI_HEADER_BYTES;
-					iovs[batch_count][1].iov_base = payload_ptr;
-					iovs[batch_count][1].iov_len  = (size_t)g_payload_bytes;
-					msgvec[batch_count].msg_hdr.msg_iov = &iovs[batch_count][0];
-					msgvec[batch_count].msg_hdr.msg_iovlen = 2;
-					batch_count++;
-				}
-			}
-		}
-
-		if (!use_dedicated_send) {
-			if (batch_count > 0 && !g_no_send) {
-				uint64_t tsc_before = rte_rdtsc();
-				int sent = sendmmsg(g_udp_sock, msgvec, batch_count, 0);
-				__atomic_fetch_add(&g_tsc_in_send_interval, (rte_rdtsc() - tsc_before), __ATOMIC_RELAXED);
-				if (sent > 0) {
-					for (unsigned int i = 0; i < (unsigned int)sent && i < batch_count; i++)
-						g_sent[batch_stream_ids[i]]++;
+					if (ctx_pkt) {
+						if (!batch_has_room(1))
+							batch_flush(&prof_tsc);
+						g_batch.iov[g_batch.iov_used].iov_base = (void *)ctx_pkt;
+						g_batch.iov[g_batch.iov_used].iov_len  = (size_t)ctx_len;
+						batch_add(s, 1, 1);
+						ctx_sched_commit(s, tsc_now);
+					}
+					if (g_dsp_enabled) {
+						DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HANDOFF, prof_tsc);
+						chunk_read(s, &cur, g_payload_bytes, g_dsp_out_bufs[s]);
+						DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_DSP, prof_tsc);
+					}
+					/* Zero-copy: header iovec plus one iovec per segment piece of the packet */
+					for (k = 0; k < g_pkts_per_chunk; k++) {
+						if (!batch_has_room(1u + chunk_mbuf->nb_segs))
+							batch_flush(&prof_tsc);
+						struct iovec *iov = &g_batch.iov[g_batch.iov_used];
+						unsigned int iovcnt = 1;
+						iov[0].iov_base = hdr_bufs + k * DIFI_HEADER_BYTES;
+						iov[0].iov_len  = DIFI_HEADER_BYTES;
+						if (g_dsp_enabled) {
+							iov[1].iov_base = g_dsp_out_bufs[s] + (size_t)k * g_pkt_payload_bytes;
+							iov[1].iov_len  = (size_t)g_pkt_payload_bytes;
+							iovcnt = 2;
+						} else {
+							const uint8_t *p;
+							uint32_t left = g_pkt_in_bytes, n;
+							while (left > 0 && (n = chunk_cursor_next(&cur, left, &p)) > 0) {
+								iov[iovcnt].iov_base = (void *)p;
+								iov[iovcnt].iov_len  = n;
+								iovcnt++;
+								left -= n;
+							}
+						}
+						batch_add(s, iovcnt, 0);
+					}
+					g_batch.free_m[g_batch.count - 1] = chunk_mbuf;
+					DIFI_PROF_STAGE(&g_prof_drain, DIFI_PROF_HANDOFF, prof_tsc);
 				}
-				if (sent >= 0 && (unsigned int)sent < batch_count)
-					g_outbound_errors += (unsigned int)batch_count - (unsigned int)sent;
-				else if (sent < 0)
-					g_outbound_errors += (unsigned int)batch_count;
 			}
-			for (unsigned int i = 0; i < batch_count; i++)
-				rte_pktmbuf_free((struct rte_mbuf *)batch_objs[i]);
 		}
+		if (!use_dedicated_send && g_batch.count > 0)
+			batch_flush(&prof_tsc);
 
 		/* Stats every 1 second */
 		{
-			uint64_t tsc_now = rte_rdtsc();
+			tsc_now = rte_rdtsc();
 			if (tsc_now - g_last_tsc >= tsc_hz) {
 				uint64_t total_dq = 0, total_sent = 0;
 				for (s = 0; s < g_streams; s++) {
@@ -623,6 +1338,25 @@ int main(int argc, char **argv)
 				printf("DIFI RX: inbound %" PRIu64 "/s, outbound %" PRIu64 "/s (dest %s:%u) time_in_send %.1f%% in_err %.2f%% out_err %.2f%%\n",
 					(uint64_t)((double)d_dq / sec), (uint64_t)((double)d_sent / sec),
 					g_dest_addr, (unsigned)g_dest_port, pct_send, inbound_err_pct, outbound_err_pct);
+				if (g_reorder_window > 0) {
+					struct iq_reorder t;
+					reorder_totals(&t);
+					printf("REORDER: held %u reordered %" PRIu64 " (max depth %" PRIu64 ") late %" PRIu64
+						" dup %" PRIu64 " skipped %" PRIu64 "\n",
+						(unsigned)t.held, t.reordered, t.max_depth, t.late, t.duplicates, t.skipped);
+				}
+				if (DIFI_PROF_ON()) {
+					static struct difi_prof drain_last, send_last;
+					struct difi_prof cur;
+					difi_prof_snapshot(&g_prof_drain, &cur);
+					difi_prof_print_interval("drain", &cur, &drain_last);
+					drain_last = cur;
+					if (use_dedicated_send) {
+						difi_prof_snapshot(&g_prof_send, &cur);
+						difi_prof_print_interval("send", &cur, &send_last);
+						send_last = cur;
+					}
+				}
 			}
 		}
 	}
@@ -630,6 +1364,14 @@ int main(int argc, char **argv)
 	if (use_dedicated_send && send_lcore_id < RTE_MAX_LCORE)
 		rte_eal_wait_lcore(send_lcore_id);
 
+	/* Chunks still waiting in reorder windows were dequeued but not sent */
+	uint64_t reorder_held_at_exit = 0;
+	if (g_reorder_window > 0) {
+		for (s = 0; s < g_streams; s++)
+			reorder_held_at_exit += iq_reorder_drain(&g_reorder[s]);
+		g_inbound_errors += reorder_held_at_exit;
+	}
+
 	/* Optional: send context packets with EOB/EOS before exit */
 	if (g_udp_sock >= 0 && (g_eob_on_exit || g_eos_on_exit))
 		send_sei_context_packets_on_exit();
@@ -653,13 +1395,13 @@ int main(int argc, char **argv)
 		double inbound_mbps_payload = (duration_sec > 0.0) ? ((double)inbound_payload * 8.0 / 1e6 / duration_sec) : 0.0;
 
 		/* Outbound: DIFI packets sent over UDP */
-		uint64_t outbound_bytes = total_sent * (DIFI_HEADER_BYTES + g_payload_bytes);
-		uint64_t outbound_payload = total_sent * (uint64_t)g_payload_bytes;
+		uint64_t outbound_bytes = total_sent * (uint64_t)g_packet_len;
+		uint64_t outbound_payload = total_sent * (uint64_t)g_pkt_payload_bytes;
 		double outbound_pps = (duration_sec > 0.0) ? ((double)total_sent / duration_sec) : 0.0;
 		double outbound_mbps_wire = (duration_sec > 0.0) ? ((double)outbound_bytes * 8.0 / 1e6 / duration_sec) : 0.0;
 		double outbound_mbps_payload = (duration_sec > 0.0) ? ((double)outbound_payload * 8.0 / 1e6 / duration_sec) : 0.0;
 
-		double theoretical_mbps = (double)IQ_DEFAULT_SAMPLE_RATE_HZ * 2.0 * (double)g_streams * 8.0 / 1e6;
+		double theoretical_mbps = (double)g_out_sample_rate_hz * 2.0 * (double)g_streams * 8.0 / 1e6;
 		double utilization_pct = (theoretical_mbps > 0.0) ? (100.0 * outbound_mbps_payload / theoretical_mbps) : 0.0;
 
 		printf("\n=== difi_dpdk_receiver final ===\n");
@@ -682,8 +1424,40 @@ int main(int argc, char **argv)
 		printf("Bytes sent:      %" PRIu64 " (wire), %" PRIu64 " (payload)\n", outbound_bytes, outbound_payload);
 		printf("Throughput:       %.1f packets/s, %.2f Mbps (wire), %.2f Mbps (payload)\n",
 			outbound_pps, outbound_mbps_wire, outbound_mbps_payload);
-		printf("Theoretical:      %.2f Mbps (%.0f Msps x 2 B x %u streams); utilization %.1f%%\n\n",
-			theoretical_mbps, (double)IQ_DEFAULT_SAMPLE_RATE_HZ / 1e6, (unsigned)g_streams, utilization_pct);
+		printf("Theoretical:      %.2f Mbps (%.2f Msps x 2 B x %u streams); utilization %.1f%%\n",
+			theoretical_mbps, (double)g_out_sample_rate_hz / 1e6, (unsigned)g_streams, utilization_pct);
+		{
+			uint64_t total_ctx = 0;
+			for (s = 0; s < g_streams; s++)
+				total_ctx += __atomic_load_n(&g_ctx_sent[s], __ATOMIC_RELAXED);
+			printf("Context packets:  %" PRIu64 " (interval %u ms, plus start/change)\n\n",
+				total_ctx, (unsigned)g_context_interval_ms);
+		}
+
+		if (g_reorder_window > 0) {
+			struct iq_reorder t;
+			reorder_totals(&t);
+			printf("--- Reorder (window %d, timeout %u us, %s rings) ---\n", g_reorder_window,
+				(unsigned)g_reorder_timeout_us, g_mp_ingress ? "multi-producer" : "single-producer");
+			printf("Released:         %" PRIu64 " in order, %" PRIu64 " arrived out of order (max depth %" PRIu64
+				", peak held %" PRIu64 ")\n", t.released, t.reordered, t.max_depth, t.max_held);
+			printf("Dropped:          late %" PRIu64 ", duplicate %" PRIu64 ", held at exit %" PRIu64 "\n",
+				t.late, t.duplicates, reorder_held_at_exit);
+			printf("Skipped seqs:     %" PRIu64 " (missing at window full or timeout)\n", t.skipped);
+			if (g_streams <= 16) {
+				printf("Per-stream late:  ");
+				for (s = 0; s < g_streams; s++)
+					printf("%" PRIu64 "%s", g_reorder[s].late, (s + 1 < g_streams) ? ", " : "\n");
+			}
+			printf("\n");
+		}
+
+		if (DIFI_PROF_ON()) {
+			difi_prof_print_summary("drain (main lcore)", &g_prof_drain, tsc_hz);
+			if (use_dedicated_send)
+				difi_prof_print_summary("send worker", &g_prof_send, tsc_hz);
+			printf("\n");
+		}
 
 		if (g_streams <= 16) {
 			printf("Per-stream inbound (dequeued): ");
@@ -702,9 +1476,15 @@ int main(int argc, char **argv)
 			free(g_send_pool[i].buf);
 		free(g_send_pool);
 		g_send_pool = NULL;
+		free(g_chunk_items);
+		g_chunk_items = NULL;
 	}
-	for (s = 0; s < g_streams; s++)
+	for (s = 0; s < g_streams; s++) {
 		free(g_mbuf_header_bufs[s]);
+		free(g_dsp_out_bufs[s]);
+		if (g_dsp_enabled)
+			iq_dsp_stream_free(&g_dsp[s]);
+	}
 	rte_eal_cleanup();
 	return 0;
 }
@@ -0,0 +1,386 @@
+/*
+ * difi_ingest: DIFI over UDP -> per-stream IQ chunk rings.
+ *
+ * Receive path per burst:
+ *   1. Every receive slot holds a fresh mbuf; recvmmsg() writes each datagram
+ *      at the mbuf data start, i.e. [DIFI hdr 32B][IQ payload].
+ *   2. The DIFI header is validated (packet type, Class ID present, OUI,
+ *      packet size words, stream id) and the 4-bit sequence is tracked.
+ *   3. If the packet carries exactly one chunk, the DIFI header is overwritten
+ *      with struct iq_chunk_hdr and the mbuf is enqueued as-is (no copy).
+ *      Smaller packets are appended to a per-stream reassembly mbuf.
+ * With UDP_GRO one datagram buffer may hold several DIFI packets of gso_size
+ * bytes; each becomes an indirect mbuf over the shared buffer.
+ */
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+#include "difi_ingest.h"
+#include "difi.h"
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+
+#define INGEST_PTYPE_CONTEXT  0x4u
+#define INGEST_CLASS_ID_BIT   0x08000000u
+#define INGEST_RCVBUF_BYTES   (32 * 1024 * 1024)
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline uint64_t load_be64(const uint8_t *p)
+{
+	return ((uint64_t)load_be32(p) << 32) | (uint64_t)load_be32(p + 4);
+}
+
+int difi_ingest_open(struct difi_ingest *ing, const char *addr, uint16_t port, int gro,
+	struct rte_mempool *pool, struct rte_ring **rings, uint16_t streams, uint32_t payload_bytes)
+{
+	struct sockaddr_in saddr;
+	int one = 1;
+	int rcvbuf = INGEST_RCVBUF_BYTES;
+
+	memset(ing, 0, sizeof(*ing));
+	ing->sock = -1;
+	ing->pool = pool;
+	ing->rings = rings;
+	ing->streams = streams;
+	ing->payload_bytes = payload_bytes;
+
+	int s = socket(AF_INET, SOCK_DGRAM, 0);
+	if (s < 0) {
+		perror("socket");
+		return -1;
+	}
+	memset(&saddr, 0, sizeof(saddr));
+	saddr.sin_family = AF_INET;
+	saddr.sin_port = htons(port);
+	if (inet_pton(AF_INET, addr, &saddr.sin_addr) != 1) {
+		fprintf(stderr, "Invalid bind address: %s\n", addr);
+		close(s);
+		return -1;
+	}
+	setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	/* Best effort: kernel caps at net.core.rmem_max */
+	setsockopt(s, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+	if (bind(s, (const struct sockaddr *)&saddr, sizeof(saddr)) < 0) {
+		perror("bind");
+		close(s);
+		return -1;
+	}
+	if (gro) {
+		if (setsockopt(s, SOL_UDP, UDP_GRO, &one, sizeof(one)) < 0) {
+			perror("setsockopt UDP_GRO (continuing without GRO)");
+			gro = 0;
+		}
+	}
+	ing->sock = s;
+	ing->gro = gro;
+	return 0;
+}
+
+/* Extend the 4-bit DIFI sequence; returns packets lost since the previous one (modulo 16),
+ * or -1 for a repeat of the previous sequence number (duplicate datagram) */
+static inline int track_seq(struct difi_ingest_stream *st, uint8_t seq)
+{
+	uint32_t lost = 0;
+	if (!st->seen) {
+		st->seen = 1;
+		st->ext_seq = seq;
+	} else {
+		uint32_t delta = (uint32_t)((seq - st->last_seq) & 0xF);
+		if (delta == 0) {
+			st->duplicates++;
+			return -1;
+		}
+		lost = delta - 1u;
+		st->ext_seq += delta;
+	}
+	st->last_seq = seq;
+	st->seq_lost += lost;
+	return (int)lost;
+}
+
+static inline void write_chunk_hdr(uint8_t *p, uint16_t stream_id, uint64_t seq,
+	uint64_t timestamp_ns, uint32_t payload_len)
+{
+	struct iq_chunk_hdr *hdr = (struct iq_chunk_hdr *)p;
+	hdr->magic = IQ_CHUNK_MAGIC;
+	hdr->version = IQ_CHUNK_VERSION;
+	hdr->stream_id = stream_id;
+	hdr->seq = seq;
+	hdr->timestamp_ns = timestamp_ns;
+	hdr->payload_len = payload_len;
+	hdr->reserved = 0;
+}
+
+static inline void enqueue_chunk(struct difi_ingest *ing, uint16_t s, struct rte_mbuf *m)
+{
+	if (rte_ring_sp_enqueue(ing->rings[s], m) != 0) {
+		rte_pktmbuf_free(m);
+		ing->ring_full++;
+		return;
+	}
+	ing->st[s].chunks++;
+}
+
+/* Append len payload bytes to the chunk being reassembled, chaining another mbuf from the
+ * pool when the last segment is full (chunks above one mbuf's data room). Segments are
+ * filled to even lengths so each holds whole samples. Returns -1 if the pool is empty. */
+static int asm_append(struct difi_ingest *ing, struct difi_ingest_stream *st, const uint8_t *src,
+	uint32_t len)
+{
+	struct rte_mbuf *last = rte_pktmbuf_lastseg(st->asm_m);
+
+	while (len > 0) {
+		uint32_t room = (uint32_t)rte_pktmbuf_tailroom(last) & ~1u;
+		if (room == 0) {
+			struct rte_mbuf *seg = rte_pktmbuf_alloc(ing->pool);
+			if (!seg)
+				return -1;
+			if (rte_pktmbuf_chain(st->asm_m, seg) != 0) {
+				rte_pktmbuf_free(seg);
+				return -1;
+			}
+			last = seg;
+			continue;
+		}
+		uint32_t n = (len < room) ? len : room;
+		memcpy(rte_pktmbuf_mtod_offset(last, uint8_t *, last->data_len), src, n);
+		last->data_len = (uint16_t)(last->data_len + n);
+		st->asm_m->pkt_len += n;
+		src += n;
+		len -= n;
+	}
+	return 0;
+}
+
+/* One DIFI packet at mtod(m) + off, len bytes. shared != 0 means m's buffer also holds
+ * other packets (GRO), so zero-copy uses an indirect mbuf. Returns 1 if m itself was
+ * consumed (enqueued), 0 if the caller still owns it. */
+static int ingest_packet(struct difi_ingest *ing, struct rte_mbuf *m, uint32_t off, uint32_t len,
+	int shared)
+{
+	uint8_t *p = rte_pktmbuf_mtod_offset(m, uint8_t *, off);
+
+	if (len < DIFI_INGEST_HDR_BYTES) {
+		ing->hdr_errors++;
+		return 0;
+	}
+	uint32_t word0 = load_be32(p);
+	uint32_t ptype = word0 >> 28;
+	uint32_t stream_id = load_be32(p + 4);
+	uint32_t size_bytes = (word0 & 0xFFFFu) * 4u;
+	uint32_t oui = ((uint32_t)p[8] << 16) | ((uint32_t)p[9] << 8) | (uint32_t)p[10];
+
+	if (ptype == INGEST_PTYPE_CONTEXT) {
+		if (stream_id < ing->streams)
+			ing->st[stream_id].ctx_packets++;
+		return 0;
+	}
+	if (ptype != DIFI_PTYPE_SIGNAL_DATA) {
+		ing->other_packets++;
+		return 0;
+	}
+	/* Size field is rounded up to 32-bit words; datagram may omit the pad bytes */
+	if (!(word0 & INGEST_CLASS_ID_BIT) || oui != DIFI_DEFAULT_OUI || stream_id >= ing->streams
+			|| size_bytes < len || size_bytes - len >= 4u) {
+		ing->hdr_errors++;
+		return 0;
+	}
+
+	uint16_t s = (uint16_t)stream_id;
+	struct difi_ingest_stream *st = &ing->st[s];
+	uint32_t payload_len = len - DIFI_INGEST_HDR_BYTES;
+	uint64_t ts_ns = (uint64_t)load_be32(p + 20) * 1000000000ULL + load_be64(p + 24) / 1000ULL;
+
+	if (payload_len == 0 || (payload_len & 1u) || payload_len > ing->payload_bytes
+			|| ing->payload_bytes % payload_len != 0) {
+		ing->len_errors++;
+		return 0;
+	}
+	int lost = track_seq(st, (uint8_t)((word0 >> 16) & 0xF));
+	if (lost < 0)
+		return 0;  /* duplicate: keep the chunk being reassembled */
+	st->packets++;
+
+	if (lost && st->asm_m) {
+		rte_pktmbuf_free(st->asm_m);
+		st->asm_m = NULL;
+		st->reasm_drops++;
+	}
+
+	/* Whole chunk in one packet: rewrite header in place and hand the buffer on */
+	if (payload_len == ing->payload_bytes) {
+		write_chunk_hdr(p, s, st->ext_seq, ts_ns, payload_len);
+		if (!shared) {
+			m->data_len = (uint16_t)len;
+			m->pkt_len = len;
+			enqueue_chunk(ing, s, m);
+			return 1;
+		}
+		struct rte_mbuf *mi = rte_pktmbuf_alloc(ing->pool);
+		if (!mi) {
+			ing->no_mbuf++;
+			return 0;
+		}
+		rte_pktmbuf_attach(mi, m);
+		rte_pktmbuf_adj(mi, (uint16_t)off);
+		rte_pktmbuf_trim(mi, (uint16_t)(rte_pktmbuf_pkt_len(mi) - len));
+		enqueue_chunk(ing, s, mi);
+		return 0;
+	}
+
+	/* Segmented chunk: packet k of segs carries DIFI seq chunk_seq * segs + k. The 4-bit
+	 * field only fixes ext_seq modulo 16, so k is exact when segs divides 16 (or the
+	 * stream was joined from its start). */
+	uint32_t segs = ing->payload_bytes / payload_len;
+	uint32_t k = (uint32_t)(st->ext_seq % segs);
+	if (st->asm_m && st->asm_bytes != k * payload_len) {
+		rte_pktmbuf_free(st->asm_m);
+		st->asm_m = NULL;
+		st->reasm_drops++;
+	}
+	if (!st->asm_m) {
+		if (k != 0)
+			return 0;  /* joined mid-chunk or lost the first segment: wait for the next chunk */
+		st->asm_m = rte_pktmbuf_alloc(ing->pool);
+		if (!st->asm_m) {
+			ing->no_mbuf++;
+			return 0;
+		}
+		st->asm_bytes = 0;
+		write_chunk_hdr(rte_pktmbuf_mtod(st->asm_m, uint8_t *), s, st->ext_seq / segs, ts_ns,
+			ing->payload_bytes);
+		st->asm_m->data_len = (uint16_t)sizeof(struct iq_chunk_hdr);
+		st->asm_m->pkt_len = (uint32_t)sizeof(struct iq_chunk_hdr);
+	}
+	if (asm_append(ing, st, p + DIFI_INGEST_HDR_BYTES, payload_len) != 0) {
+		rte_pktmbuf_free(st->asm_m);
+		st->asm_m = NULL;
+		ing->no_mbuf++;
+		return 0;
+	}
+	st->asm_bytes += payload_len;
+	if (st->asm_bytes == ing->payload_bytes) {
+		struct rte_mbuf *cm = st->asm_m;
+		st->asm_m = NULL;
+		enqueue_chunk(ing, s, cm);
+	}
+	return 0;
+}
+
+static int gro_segment_size(const struct msghdr *mh)
+{
+	for (struct cmsghdr *c = CMSG_FIRSTHDR(mh); c; c = CMSG_NXTHDR((struct msghdr *)mh, c)) {
+		if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+			int gso;
+			memcpy(&gso, CMSG_DATA(c), sizeof(gso));
+			return gso;
+		}
+	}
+	return 0;
+}
+
+unsigned int difi_ingest_poll(struct difi_ingest *ing)
+{
+	unsigned int i;
+
+	for (i = 0; i < DIFI_INGEST_BURST; i++) {
+		struct rte_mbuf *m = ing->slots[i];
+		if (!m) {
+			m = rte_pktmbuf_alloc(ing->pool);
+			if (!m) {
+				ing->no_mbuf++;
+				break;
+			}
+			ing->slots[i] = m;
+		}
+		/* Receive into the whole data room (65535 B, headroom unused) so a maximum-size UDP
+		 * datagram or GRO super-packet (<= 65507 B) is never truncated */
+		m->data_off = 0;
+		m->data_len = 0;  /* slot may be reused from the previous burst */
+		m->pkt_len = 0;
+		ing->iovs[i].iov_base = rte_pktmbuf_mtod(m, void *);
+		ing->iovs[i].iov_len  = (size_t)rte_pktmbuf_tailroom(m);
+		memset(&ing->msgs[i].msg_hdr, 0, sizeof(struct msghdr));
+		ing->msgs[i].msg_hdr.msg_iov = &ing->iovs[i];
+		ing->msgs[i].msg_hdr.msg_iovlen = 1;
+		if (ing->gro) {
+			ing->msgs[i].msg_hdr.msg_control = ing->cmsg[i].buf;
+			ing->msgs[i].msg_hdr.msg_controllen = sizeof(ing->cmsg[i].buf);
+		}
+	}
+	if (i == 0)
+		return 0;
+
+	int n = recvmmsg(ing->sock, ing->msgs, i, MSG_DONTWAIT, NULL);
+	if (n <= 0) {
+		if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			perror("recvmmsg");
+		return 0;
+	}
+	ing->rx_calls++;
+	ing->rx_datagrams += (uint64_t)n;
+
+	for (i = 0; i < (unsigned int)n; i++) {
+		struct rte_mbuf *m = ing->slots[i];
+		struct msghdr *mh = &ing->msgs[i].msg_hdr;
+		uint32_t len = ing->msgs[i].msg_len;
+		int gso = ing->gro ? gro_segment_size(mh) : 0;
+
+		ing->rx_bytes += len;
+		if (mh->msg_flags & MSG_TRUNC) {
+			/* Only with a smaller pool data room: keep the whole GRO segments before the cut */
+			ing->len_errors++;
+			if (gso <= 0 || len < (uint32_t)gso)
+				continue;  /* slot mbuf is reused next burst */
+			len -= len % (uint32_t)gso;
+		}
+		m->data_len = (uint16_t)len;
+		m->pkt_len = len;
+		if (gso > 0 && len > (uint32_t)gso) {
+			for (uint32_t off = 0; off < len; off += (uint32_t)gso) {
+				uint32_t seg = (len - off < (uint32_t)gso) ? (len - off) : (uint32_t)gso;
+				ingest_packet(ing, m, off, seg, 1);
+			}
+			/* Indirect mbufs hold their own references to the buffer */
+			rte_pktmbuf_free(m);
+			ing->slots[i] = NULL;
+		} else if (ingest_packet(ing, m, 0, len, 0)) {
+			ing->slots[i] = NULL;
+		}
+		/* else: not consumed (context/error/reassembled by copy); slot mbuf is reused */
+	}
+	return (unsigned int)n;
+}
+
+void difi_ingest_close(struct difi_ingest *ing)
+{
+	for (unsigned int i = 0; i < DIFI_INGEST_BURST; i++) {
+		if (ing->slots[i])
+			rte_pktmbuf_free(ing->slots[i]);
+		ing->slots[i] = NULL;
+	}
+	for (unsigned int s = 0; s < IQ_MAX_STREAMS; s++) {
+		if (ing->st[s].asm_m)
+			rte_pktmbuf_free(ing->st[s].asm_m);
+		ing->st[s].asm_m = NULL;
+	}
+	if (ing->sock >= 0)
+		close(ing->sock);
+	ing->sock = -1;
+}
@@ -0,0 +1,90 @@
+/**
+ * Report side of the per-stage profiler (see difi_prof.h).
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "difi_prof.h"
+
+int g_prof_enabled;
+
+static const char *const stage_names[DIFI_PROF_NSTAGES] = {
+	"deq", "val", "hdr", "dsp", "copy", "handoff", "sys", "idle"
+};
+
+static const char *const hist_labels[DIFI_PROF_HIST_BINS] = {
+	"1", "2", "3-4", "5-8", "9-16", "17-32", ">32"
+};
+
+void difi_prof_snapshot(const struct difi_prof *p, struct difi_prof *out)
+{
+	for (unsigned int i = 0; i < DIFI_PROF_NSTAGES; i++)
+		out->cycles[i] = __atomic_load_n(&p->cycles[i], __ATOMIC_RELAXED);
+	out->chunks = __atomic_load_n(&p->chunks, __ATOMIC_RELAXED);
+	out->polls_empty = __atomic_load_n(&p->polls_empty, __ATOMIC_RELAXED);
+	out->polls_hit = __atomic_load_n(&p->polls_hit, __ATOMIC_RELAXED);
+	out->syscalls = __atomic_load_n(&p->syscalls, __ATOMIC_RELAXED);
+	out->syscall_pkts = __atomic_load_n(&p->syscall_pkts, __ATOMIC_RELAXED);
+	for (unsigned int i = 0; i < DIFI_PROF_HIST_BINS; i++)
+		out->batch_hist[i] = __atomic_load_n(&p->batch_hist[i], __ATOMIC_RELAXED);
+}
+
+void difi_prof_print_interval(const char *tag, const struct difi_prof *cur,
+	const struct difi_prof *prev)
+{
+	uint64_t chunks = cur->chunks - prev->chunks;
+	uint64_t empty = cur->polls_empty - prev->polls_empty;
+	uint64_t polls = empty + (cur->polls_hit - prev->polls_hit);
+	uint64_t calls = cur->syscalls - prev->syscalls;
+	uint64_t pkts = cur->syscall_pkts - prev->syscall_pkts;
+	uint64_t sys_cycles = cur->cycles[DIFI_PROF_SYSCALL] - prev->cycles[DIFI_PROF_SYSCALL];
+	uint64_t idle = cur->cycles[DIFI_PROF_IDLE] - prev->cycles[DIFI_PROF_IDLE];
+	uint64_t total = idle;
+
+	printf("PROF %s: cyc/chunk", tag);
+	for (unsigned int i = 0; i < DIFI_PROF_IDLE; i++) {
+		uint64_t c = cur->cycles[i] - prev->cycles[i];
+		total += c;
+		printf(" %s %.0f", stage_names[i], chunks ? (double)c / (double)chunks : 0.0);
+	}
+	printf(" | idle %.1f%%, empty polls %.1f%%", total ? 100.0 * (double)idle / (double)total : 0.0,
+		polls ? 100.0 * (double)empty / (double)polls : 0.0);
+	if (calls)
+		printf(" | batch %.1f, sys/pkt %.0f", (double)pkts / (double)calls,
+			pkts ? (double)sys_cycles / (double)pkts : 0.0);
+	printf("\n");
+}
+
+void difi_prof_print_summary(const char *tag, const struct difi_prof *p, uint64_t tsc_hz)
+{
+	uint64_t total = 0;
+	uint64_t idle = p->cycles[DIFI_PROF_IDLE];
+	uint64_t polls = p->polls_empty + p->polls_hit;
+
+	for (unsigned int i = 0; i < DIFI_PROF_IDLE; i++)
+		total += p->cycles[i];
+
+	printf("--- Profile: %s (%" PRIu64 " chunks, %.3f s busy, %.3f s idle) ---\n",
+		tag, p->chunks, tsc_hz ? (double)total / (double)tsc_hz : 0.0,
+		tsc_hz ? (double)idle / (double)tsc_hz : 0.0);
+	for (unsigned int i = 0; i < DIFI_PROF_IDLE; i++) {
+		if (p->cycles[i] == 0)
+			continue;
+		printf("  %-8s %10.1f cyc/chunk  %5.1f%%\n", stage_names[i],
+			p->chunks ? (double)p->cycles[i] / (double)p->chunks : 0.0,
+			total ? 100.0 * (double)p->cycles[i] / (double)total : 0.0);
+	}
+	printf("  polls:   %" PRIu64 " empty, %" PRIu64 " with data (%.1f%% empty, %.0f cyc/empty poll)\n",
+		p->polls_empty, p->polls_hit, polls ? 100.0 * (double)p->polls_empty / (double)polls : 0.0,
+		p->polls_empty ? (double)idle / (double)p->polls_empty : 0.0);
+	if (p->syscalls) {
+		printf("  sendmmsg: %" PRIu64 " calls, %.1f packets/call, %.0f cyc/packet\n",
+			p->syscalls, (double)p->syscall_pkts / (double)p->syscalls,
+			p->syscall_pkts ? (double)p->cycles[DIFI_PROF_SYSCALL] / (double)p->syscall_pkts : 0.0);
+		printf("  batch sizes:");
+		for (unsigned int i = 0; i < DIFI_PROF_HIST_BINS; i++)
+			printf(" %s:%" PRIu64, hist_labels[i], p->batch_hist[i]);
+		printf("\n");
+	}
+}
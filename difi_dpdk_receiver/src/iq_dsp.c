@@ -0,0 +1,405 @@
+/*
+ * iq_dsp: NCO frequency shift + polyphase FIR decimation for 8-bit I/Q.
+ *
+ * For output n (input index n = m * decim):
+ *   y[m] = e^{-jwn} * sum_k (h[k] e^{jwk}) x[n-k]
+ * which equals low-pass filtering x[n] e^{-jwn}. Only the output-rate samples
+ * are computed (polyphase), and the rotation runs at the output rate.
+ * Samples are widened to int16 once; each output is two int16 dot products
+ * (real and imaginary) over the interleaved window.
+ */
+#define _GNU_SOURCE
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "iq_dsp.h"
+
+#define NCO_LUT_BITS  10
+#define NCO_LUT_SIZE  (1u << NCO_LUT_BITS)
+#define Q15_ONE       32767.0
+
+static int32_t g_nco_cos[NCO_LUT_SIZE];  /* Q15; int32 so AVX2 can gather */
+static int32_t g_nco_sin[NCO_LUT_SIZE];
+static int     g_nco_ready;
+
+static void nco_lut_init(void)
+{
+	if (g_nco_ready)
+		return;
+	for (uint32_t i = 0; i < NCO_LUT_SIZE; i++) {
+		double a = 2.0 * M_PI * (double)i / (double)NCO_LUT_SIZE;
+		g_nco_cos[i] = (int32_t)lround(cos(a) * Q15_ONE);
+		g_nco_sin[i] = (int32_t)lround(sin(a) * Q15_ONE);
+	}
+	g_nco_ready = 1;
+}
+
+static inline int16_t q15(double v)
+{
+	long q = lround(v * Q15_ONE);
+	if (q > 32767) q = 32767;
+	if (q < -32768) q = -32768;
+	return (int16_t)q;
+}
+
+static inline uint8_t sat_i8(int32_t v)
+{
+	if (v > 127) v = 127;
+	if (v < -128) v = -128;
+	return (uint8_t)(int8_t)v;
+}
+
+/* 32-byte aligned, zeroed; size rounded up to a multiple of 32 for aligned_alloc */
+static int16_t *alloc_i16(size_t count)
+{
+	size_t bytes = (count * sizeof(int16_t) + 31u) & ~(size_t)31u;
+	int16_t *p = aligned_alloc(32, bytes);
+	if (p)
+		memset(p, 0, bytes);
+	return p;
+}
+
+/* -------------------------------------------------------------------------
+ * Inner loops: widen int8 I/Q to int16, complex dot product over ntaps.
+ * ------------------------------------------------------------------------- */
+#if defined(__AVX2__)
+
+static inline void widen_i8(int16_t *dst, const uint8_t *src, uint32_t samples)
+{
+	uint32_t bytes = samples * 2u, i = 0;
+	for (; i + 16u <= bytes; i += 16u) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_cvtepi8_epi16(v));
+	}
+	for (; i < bytes; i++)
+		dst[i] = (int16_t)(int8_t)src[i];
+}
+
+static inline void cdot(const int16_t *x, const int16_t *tr, const int16_t *ti, uint32_t ntaps,
+	int32_t *re, int32_t *im)
+{
+	__m256i ar = _mm256_setzero_si256();
+	__m256i ai = _mm256_setzero_si256();
+	for (uint32_t j = 0; j < ntaps * 2u; j += 16u) {
+		__m256i v = _mm256_loadu_si256((const __m256i *)(x + j));
+		ar = _mm256_add_epi32(ar, _mm256_madd_epi16(v, _mm256_load_si256((const __m256i *)(tr + j))));
+		ai = _mm256_add_epi32(ai, _mm256_madd_epi16(v, _mm256_load_si256((const __m256i *)(ti + j))));
+	}
+	/* Reduce both accumulators together: lanes end up {re, im, re, im} */
+	__m256i h = _mm256_hadd_epi32(ar, ai);
+	h = _mm256_hadd_epi32(h, h);
+	__m128i s = _mm_add_epi32(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+	*re = _mm_cvtsi128_si32(s);
+	*im = _mm_extract_epi32(s, 1);
+}
+
+/* Eight consecutive outputs per pass. The window is first split into decim
+ * polyphase branches (branch p holds work samples p, p+D, p+2D, ... as 32-bit
+ * {I,Q} pairs) so output lanes load contiguously and each tap is one broadcast
+ * madd for all eight outputs; rotation, rounding and int8 packing stay in
+ * vector registers. Returns outputs written (n_out). */
+#define IQ_DSP_HAVE_BLOCK8 1
+
+static uint32_t fir_block8(struct iq_dsp_stream *st, uint32_t n_out, uint8_t *out)
+{
+	const uint32_t D = st->decim, tpp = st->ntaps / D;
+	const uint32_t groups = (n_out + 7u) / 8u;
+	const uint32_t blen = groups * 8u + tpp;
+	const uint32_t *w = (const uint32_t *)st->work;
+	const uint32_t *tr = (const uint32_t *)st->taps_re;
+	const uint32_t *ti = (const uint32_t *)st->taps_im;
+	uint32_t *poly = (uint32_t *)st->poly;
+
+	for (uint32_t p = 0; p < D; p++) {
+		uint32_t *b = poly + (size_t)p * st->poly_len;
+		for (uint32_t q = 0; q < blen; q++)
+			b[q] = w[q * D + p];
+	}
+
+	const __m256i rnd = _mm256_set1_epi32(1 << 14);
+	const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	uint32_t phase = st->phase;
+	for (uint32_t g = 0; g < groups; g++) {
+		__m256i ar = _mm256_setzero_si256();
+		__m256i ai = _mm256_setzero_si256();
+		for (uint32_t i = 0; i < tpp; i++) {
+			for (uint32_t p = 0; p < D; p++) {
+				uint32_t j = i * D + p;
+				__m256i v = _mm256_loadu_si256((const __m256i *)(poly + (size_t)p * st->poly_len + g * 8u + i));
+				ar = _mm256_add_epi32(ar, _mm256_madd_epi16(v, _mm256_set1_epi32((int)tr[j])));
+				ai = _mm256_add_epi32(ai, _mm256_madd_epi16(v, _mm256_set1_epi32((int)ti[j])));
+			}
+		}
+		ar = _mm256_srai_epi32(_mm256_add_epi32(ar, rnd), 15);
+		ai = _mm256_srai_epi32(_mm256_add_epi32(ai, rnd), 15);
+		if (st->rotate) {
+			__m256i ph = _mm256_add_epi32(_mm256_set1_epi32((int)phase),
+				_mm256_mullo_epi32(lane, _mm256_set1_epi32((int)st->phase_inc)));
+			__m256i idx = _mm256_srli_epi32(ph, 32 - NCO_LUT_BITS);
+			__m256i c = _mm256_i32gather_epi32((const int *)g_nco_cos, idx, 4);
+			__m256i s = _mm256_i32gather_epi32((const int *)g_nco_sin, idx, 4);
+			__m256i r2 = _mm256_add_epi32(_mm256_mullo_epi32(ar, c), _mm256_mullo_epi32(ai, s));
+			__m256i i2 = _mm256_sub_epi32(_mm256_mullo_epi32(ai, c), _mm256_mullo_epi32(ar, s));
+			ar = _mm256_srai_epi32(_mm256_add_epi32(r2, rnd), 15);
+			ai = _mm256_srai_epi32(_mm256_add_epi32(i2, rnd), 15);
+			phase += 8u * st->phase_inc;
+		}
+		/* {re,im} interleave, saturate to int16 then int8, gather the two 64-bit halves */
+		__m256i lo = _mm256_unpacklo_epi32(ar, ai);
+		__m256i hi = _mm256_unpackhi_epi32(ar, ai);
+		__m256i v16 = _mm256_packs_epi32(lo, hi);
+		__m256i v8 = _mm256_permute4x64_epi64(_mm256_packs_epi16(v16, v16), _MM_SHUFFLE(3, 1, 2, 0));
+		uint32_t n = n_out - g * 8u;
+		if (n >= 8u) {
+			_mm_storeu_si128((__m128i *)(out + g * 16u), _mm256_castsi256_si128(v8));
+		} else {
+			uint8_t tmp[16];
+			_mm_storeu_si128((__m128i *)tmp, _mm256_castsi256_si128(v8));
+			memcpy(out + g * 16u, tmp, (size_t)n * 2u);
+			/* Lanes past n_out were computed but not emitted; rewind their phase steps */
+			if (st->rotate)
+				phase -= (8u - n) * st->phase_inc;
+		}
+	}
+	st->phase = phase;
+	return n_out;
+}
+
+#elif defined(__ARM_NEON)
+
+static inline void widen_i8(int16_t *dst, const uint8_t *src, uint32_t samples)
+{
+	uint32_t bytes = samples * 2u, i = 0;
+	for (; i + 8u <= bytes; i += 8u)
+		vst1q_s16(dst + i, vmovl_s8(vld1_s8((const int8_t *)(src + i))));
+	for (; i < bytes; i++)
+		dst[i] = (int16_t)(int8_t)src[i];
+}
+
+static inline int32_t hsum_s32(int32x4_t v)
+{
+#if defined(__aarch64__)
+	return vaddvq_s32(v);
+#else
+	int32x2_t s = vadd_s32(vget_low_s32(v), vget_high_s32(v));
+	return vget_lane_s32(vpadd_s32(s, s), 0);
+#endif
+}
+
+static inline void cdot(const int16_t *x, const int16_t *tr, const int16_t *ti, uint32_t ntaps,
+	int32_t *re, int32_t *im)
+{
+	int32x4_t ar = vdupq_n_s32(0);
+	int32x4_t ai = vdupq_n_s32(0);
+	for (uint32_t j = 0; j < ntaps * 2u; j += 8u) {
+		int16x8_t v  = vld1q_s16(x + j);
+		int16x8_t vr = vld1q_s16(tr + j);
+		int16x8_t vi = vld1q_s16(ti + j);
+		ar = vmlal_s16(ar, vget_low_s16(v), vget_low_s16(vr));
+		ar = vmlal_s16(ar, vget_high_s16(v), vget_high_s16(vr));
+		ai = vmlal_s16(ai, vget_low_s16(v), vget_low_s16(vi));
+		ai = vmlal_s16(ai, vget_high_s16(v), vget_high_s16(vi));
+	}
+	*re = hsum_s32(ar);
+	*im = hsum_s32(ai);
+}
+
+#else
+
+static inline void widen_i8(int16_t *dst, const uint8_t *src, uint32_t samples)
+{
+	for (uint32_t i = 0; i < samples * 2u; i++)
+		dst[i] = (int16_t)(int8_t)src[i];
+}
+
+static inline void cdot(const int16_t *x, const int16_t *tr, const int16_t *ti, uint32_t ntaps,
+	int32_t *re, int32_t *im)
+{
+	int32_t ar = 0, ai = 0;
+	for (uint32_t j = 0; j < ntaps * 2u; j++) {
+		ar += (int32_t)x[j] * tr[j];
+		ai += (int32_t)x[j] * ti[j];
+	}
+	*re = ar;
+	*im = ai;
+}
+
+#endif
+
+const char *iq_dsp_isa(void)
+{
+#if defined(__AVX2__)
+	return "avx2";
+#elif defined(__ARM_NEON)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
+
+/* -------------------------------------------------------------------------
+ * Setup: Hamming-windowed sinc low-pass, cutoff 0.4 / decim (80% of output
+ * Nyquist band), unity DC gain, modulated by e^{jwk} and stored reversed so
+ * the dot product walks the window forward. decim == 1 has no filter and
+ * only runs the NCO.
+ * ------------------------------------------------------------------------- */
+int iq_dsp_stream_init(struct iq_dsp_stream *st, uint32_t decim, double shift_hz,
+	uint32_t sample_rate_hz)
+{
+	memset(st, 0, sizeof(*st));
+	if (decim < 1u || decim > IQ_DSP_MAX_DECIM || sample_rate_hz == 0)
+		return -1;
+	if (fabs(shift_hz) >= (double)sample_rate_hz / 2.0)
+		return -1;
+	nco_lut_init();
+
+	/* NCO increment: shift as a fraction of 2^32 per input sample (negative wraps) */
+	uint32_t inc = (uint32_t)(int64_t)llround(shift_hz / (double)sample_rate_hz * 4294967296.0);
+	st->decim     = decim;
+	st->phase_inc = inc * decim;
+	st->rotate    = (inc != 0);
+	if (decim == 1u)
+		return 0;
+
+	uint32_t ntaps = IQ_DSP_TAPS_PER_PHASE * decim;
+	double w = 2.0 * M_PI * shift_hz / (double)sample_rate_hz;
+	double fc = 0.4 / (double)decim;
+	double mid = (double)(ntaps - 1u) / 2.0;
+	double sum = 0.0;
+	double *h = calloc(ntaps, sizeof(double));
+	if (!h)
+		return -1;
+	for (uint32_t k = 0; k < ntaps; k++) {
+		double t = (double)k - mid;
+		double sinc = (t == 0.0) ? 2.0 * fc : sin(2.0 * M_PI * fc * t) / (M_PI * t);
+		double win = 0.54 - 0.46 * cos(2.0 * M_PI * (double)k / (double)(ntaps - 1u));
+		h[k] = sinc * win;
+		sum += h[k];
+	}
+
+	st->taps_re = alloc_i16((size_t)ntaps * 2u);
+	st->taps_im = alloc_i16((size_t)ntaps * 2u);
+	/* work[] is padded by 8 output steps so the last partial AVX2 group reads in bounds */
+	st->work    = alloc_i16(((size_t)ntaps + IQ_DSP_BLOCK_SAMPLES + 8u * decim) * 2u);
+#if defined(IQ_DSP_HAVE_BLOCK8)
+	st->poly_len = (IQ_DSP_BLOCK_SAMPLES + ntaps) / decim + 8u + IQ_DSP_TAPS_PER_PHASE;
+	st->poly     = alloc_i16((size_t)decim * st->poly_len * 2u);
+	if (!st->poly) {
+		free(h);
+		iq_dsp_stream_free(st);
+		return -1;
+	}
+#endif
+	if (!st->taps_re || !st->taps_im || !st->work) {
+		free(h);
+		iq_dsp_stream_free(st);
+		return -1;
+	}
+	for (uint32_t k = 0; k < ntaps; k++) {
+		uint32_t j = ntaps - 1u - k;
+		double gr = h[k] / sum * cos(w * (double)k);
+		double gi = h[k] / sum * sin(w * (double)k);
+		st->taps_re[2u * j]      = q15(gr);
+		st->taps_re[2u * j + 1u] = q15(-gi);
+		st->taps_im[2u * j]      = q15(gi);
+		st->taps_im[2u * j + 1u] = q15(gr);
+	}
+	free(h);
+
+	st->ntaps = ntaps;
+	st->avail = ntaps - 1u;  /* zero history: first output aligns with input sample 0 */
+	return 0;
+}
+
+void iq_dsp_stream_free(struct iq_dsp_stream *st)
+{
+	free(st->taps_re);
+	free(st->taps_im);
+	free(st->work);
+	free(st->poly);
+	st->taps_re = st->taps_im = st->work = st->poly = NULL;
+}
+
+/* decim == 1: rotate each input sample directly */
+static uint32_t shift_only(struct iq_dsp_stream *st, const uint8_t *in, uint32_t in_samples,
+	uint8_t *out)
+{
+	uint32_t phase = st->phase, inc = st->phase_inc;
+	for (uint32_t i = 0; i < in_samples; i++) {
+		int32_t re = (int8_t)in[2u * i], im = (int8_t)in[2u * i + 1u];
+		uint32_t idx = phase >> (32 - NCO_LUT_BITS);
+		int32_t c = g_nco_cos[idx], s = g_nco_sin[idx];
+		out[2u * i]      = sat_i8((re * c + im * s + (1 << 14)) >> 15);
+		out[2u * i + 1u] = sat_i8((im * c - re * s + (1 << 14)) >> 15);
+		phase += inc;
+	}
+	st->phase = phase;
+	return in_samples;
+}
+
+uint32_t iq_dsp_process(struct iq_dsp_stream *st, const uint8_t *in, uint32_t in_samples,
+	uint8_t *out)
+{
+	uint32_t produced = 0;
+
+	if (st->decim == 1u) {
+		if (!st->rotate) {
+			memcpy(out, in, (size_t)in_samples * 2u);
+			return in_samples;
+		}
+		return shift_only(st, in, in_samples, out);
+	}
+
+	while (in_samples > 0) {
+		uint32_t n = (in_samples < IQ_DSP_BLOCK_SAMPLES) ? in_samples : IQ_DSP_BLOCK_SAMPLES;
+		widen_i8(st->work + 2u * st->avail, in, n);
+		st->avail += n;
+		in += 2u * n;
+		in_samples -= n;
+
+		uint32_t start = 0;
+#if defined(IQ_DSP_HAVE_BLOCK8)
+		if (st->avail >= st->ntaps) {
+			uint32_t n_out = (st->avail - st->ntaps) / st->decim + 1u;
+			fir_block8(st, n_out, out);
+			out += 2u * n_out;
+			produced += n_out;
+			start = n_out * st->decim;
+		}
+#endif
+		while (start + st->ntaps <= st->avail) {
+			int32_t re, im;
+			cdot(st->work + 2u * start, st->taps_re, st->taps_im, st->ntaps, &re, &im);
+			re = (re + (1 << 14)) >> 15;
+			im = (im + (1 << 14)) >> 15;
+			if (st->rotate) {
+				uint32_t idx = st->phase >> (32 - NCO_LUT_BITS);
+				int32_t c = g_nco_cos[idx], s = g_nco_sin[idx];
+				int32_t r2 = (re * c + im * s + (1 << 14)) >> 15;
+				int32_t i2 = (im * c - re * s + (1 << 14)) >> 15;
+				re = r2;
+				im = i2;
+				st->phase += st->phase_inc;
+			}
+			out[0] = sat_i8(re);
+			out[1] = sat_i8(im);
+			out += 2;
+			produced++;
+			start += st->decim;
+		}
+
+		/* Keep the unconsumed tail (< ntaps samples) as history for the next block */
+		uint32_t keep = st->avail - start;
+		memmove(st->work, st->work + 2u * start, (size_t)keep * 2u * sizeof(int16_t));
+		st->avail = keep;
+	}
+	return produced;
+}
@@ -0,0 +1,130 @@
+/**
+ * Per-stream reorder window (see iq_reorder.h).
+ */
+#include <string.h>
+
+#include "iq_reorder.h"
+
+int iq_reorder_init(struct iq_reorder *r, uint32_t window)
+{
+	memset(r, 0, sizeof(*r));
+	if (window < 1 || window > IQ_REORDER_MAX_WINDOW)
+		return -1;
+	r->window = window;
+	return 0;
+}
+
+/* Move the overflow chunk into the window once it fits */
+static inline void admit_overflow(struct iq_reorder *r)
+{
+	if (!r->overflow || r->overflow_seq >= r->next_seq + r->window)
+		return;
+	r->slot[r->overflow_seq % r->window] = r->overflow;
+	r->overflow = NULL;
+	r->held++;
+	if (r->held > r->max_held)
+		r->max_held = r->held;
+}
+
+int iq_reorder_push(struct iq_reorder *r, struct rte_mbuf *m, uint64_t seq)
+{
+	/* First chunk, or the producer restarted its sequence with nothing pending: far
+	 * behind, or an increasing run of late chunks too long to be reordering */
+	if (!r->started || (seq < r->next_seq && r->held == 0 && !r->overflow
+			&& (r->next_seq - seq > 4u * IQ_REORDER_MAX_WINDOW || r->late_run >= 2u * r->window + 16u))) {
+		r->started = 1;
+		r->next_seq = seq;
+		r->max_seq = seq;
+		r->gap_tsc = 0;
+	}
+	if (seq < r->next_seq) {
+		r->late++;
+		r->late_run = (r->late_run > 0 && seq > r->last_late_seq) ? r->late_run + 1u : 1u;
+		r->last_late_seq = seq;
+		return IQ_REORDER_LATE;
+	}
+	r->late_run = 0;
+	if (seq >= r->next_seq + r->window) {
+		r->overflow = m;
+		r->overflow_seq = seq;
+		if (seq > r->max_seq)
+			r->max_seq = seq;
+		return IQ_REORDER_HELD;
+	}
+
+	uint32_t idx = (uint32_t)(seq % r->window);
+	if (r->slot[idx]) {
+		r->duplicates++;
+		return IQ_REORDER_DUP;
+	}
+	if (seq < r->max_seq) {
+		r->reordered++;
+		if (r->max_seq - seq > r->max_depth)
+			r->max_depth = r->max_seq - seq;
+	} else {
+		r->max_seq = seq;
+	}
+	r->slot[idx] = m;
+	r->held++;
+	if (r->held > r->max_held)
+		r->max_held = r->held;
+	return IQ_REORDER_HELD;
+}
+
+struct rte_mbuf *iq_reorder_pop(struct iq_reorder *r, uint64_t tsc_now, uint64_t timeout_tsc)
+{
+	for (;;) {
+		uint32_t idx = (uint32_t)(r->next_seq % r->window);
+		struct rte_mbuf *m = r->slot[idx];
+
+		if (m) {
+			r->slot[idx] = NULL;
+			r->held--;
+			r->next_seq++;
+			r->released++;
+			r->gap_tsc = 0;
+			admit_overflow(r);
+			return m;
+		}
+		if (r->held == 0 && !r->overflow) {
+			r->gap_tsc = 0;
+			return NULL;
+		}
+		/* next_seq missing with later chunks waiting. Unless the window is full, give the
+		 * missing chunk until the timeout; once given up, skip consecutive gaps at once. */
+		if (!r->overflow) {
+			if (r->gap_tsc == 0)
+				r->gap_tsc = tsc_now;
+			if (tsc_now - r->gap_tsc < timeout_tsc)
+				return NULL;
+		}
+		if (r->held == 0) {
+			r->skipped += r->overflow_seq - r->next_seq;
+			r->next_seq = r->overflow_seq;
+		} else {
+			r->skipped++;
+			r->next_seq++;
+		}
+		admit_overflow(r);
+	}
+}
+
+unsigned int iq_reorder_drain(struct iq_reorder *r)
+{
+	unsigned int n = 0;
+
+	for (uint32_t i = 0; i < r->window; i++) {
+		if (r->slot[i]) {
+			rte_pktmbuf_free(r->slot[i]);
+			r->slot[i] = NULL;
+			n++;
+		}
+	}
+	if (r->overflow) {
+		rte_pktmbuf_free(r->overflow);
+		r->overflow = NULL;
+		n++;
+	}
+	r->held = 0;
+	return n;
+}